@@ -0,0 +1,79 @@
+/*!
+ * Memory benchmark for the word store.
+ * @file bench_dictionary_memory.cpp
+ *
+ * Loads a synthetic words file into the old layout (a vector of Word
+ * structs plus full copies of each in the easy/normal/hard vectors)
+ * and into the dictionary image, and reports the live heap bytes each
+ * one keeps.
+ *
+ * Usage: bench_dictionary_memory [n_entries]
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <malloc.h>
+
+#include "../utils/utf8.h"
+#include "dictionary.h"
+#include "words_csv.h"
+
+static long long g_live_bytes = 0;
+
+void *operator new(size_t n) {
+  if (void *p = std::malloc(n)) {
+    g_live_bytes += static_cast<long long>(malloc_usable_size(p));
+    return p;
+  }
+  throw std::bad_alloc();
+}
+void operator delete(void *p) noexcept {
+  if (p != nullptr) { g_live_bytes -= static_cast<long long>(malloc_usable_size(p)); }
+  std::free(p);
+}
+void operator delete(void *p, size_t) noexcept { operator delete(p); }
+
+struct Word {
+  std::wstring word;
+  std::vector<std::wstring> categories;
+};
+
+int main(int argc, char *argv[]) {
+  size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+  static const char *categories[] = {"pessoas", "lugar", "objeto,arte", "conceito",
+                                     "fruta,comida", "construcao,lugar"};
+  std::string csv = "palavra,Categoria\n";
+  for (size_t i = 0; i < n; ++i) {
+    csv += "palavra" + std::to_string(i % 9 == 0 ? i : i % 1000) + "," + categories[i % 6] + "\n";
+  }
+
+  long long before = g_live_bytes;
+  {
+    std::vector<Word> all, easy, normal, hard;
+    words_csv::for_each_entry(csv, [&](std::string_view word, std::string_view cats) {
+      Word entry;
+      utf8::append_upper(entry.word, word);
+      while (!cats.empty()) {
+        utf8::append_upper(entry.categories.emplace_back(), words_csv::next_field(cats));
+      }
+      all.push_back(std::move(entry));
+    });
+    for (const Word &w : all) {
+      if (w.word.size() > 6) { hard.push_back(w); }
+      else if (w.word.size() > 4) { normal.push_back(w); }
+      easy.push_back(w);
+    }
+    std::cout << "Word structs + tier copies: " << (g_live_bytes - before) / 1024 << " KiB\n";
+  }
+
+  before = g_live_bytes;
+  {
+    std::vector<uint32_t> image = Dictionary::compile(csv);
+    std::cout << "Dictionary image:           " << (g_live_bytes - before) / 1024 << " KiB\n";
+  }
+  return EXIT_SUCCESS;
+}
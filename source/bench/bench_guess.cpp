@@ -0,0 +1,91 @@
+/*!
+ * Guess throughput benchmark.
+ * @file bench_guess.cpp
+ *
+ * Plays whole matches against a long secret phrase, guessing every
+ * letter of the alphabet in turn, the same way GameController drives
+ * HangmanWord. Reports guesses per second for the original linear scan
+ * engine and for the bitmask engine.
+ *
+ * Usage: bench_guess [phrase_length] [matches]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "alphabet.h"
+#include "hm_word.h"
+
+/// The guess path as it was before the bitmask engine.
+struct LinearWord {
+  std::wstring secret, masked;
+  std::vector<wchar_t> wrong, correct;
+
+  void initialize(const std::wstring &sw) {
+    secret = sw;
+    masked.clear();
+    for (size_t i = 0; i < secret.size(); ++i) { masked = masked + L"_" + L" "; }
+    wrong.clear();
+    correct.clear();
+  }
+  HangmanWord::guess_e guess(wchar_t g) const {
+    for (wchar_t c : wrong) { if (c == g) { return HangmanWord::guess_e::REPEATED; } }
+    for (wchar_t c : correct) { if (c == g) { return HangmanWord::guess_e::REPEATED; } }
+    for (wchar_t c : secret) { if (c == g) { return HangmanWord::guess_e::CORRECT; } }
+    return HangmanWord::guess_e::WRONG;
+  }
+  void add_wrong_guess(wchar_t g) { wrong.push_back(g); }
+  void add_correct_guess(wchar_t g) { correct.push_back(g); }
+  void unmasked_char(wchar_t g) {
+    for (size_t i = 0; i < secret.size(); ++i) { if (secret[i] == g) { masked[i * 2] = g; } }
+  }
+  bool all_unmasked() const {
+    for (wchar_t c : masked) { if (c == L'_') { return false; } }
+    return true;
+  }
+};
+
+template <typename Word> static void run(const char *label, const std::wstring &phrase, size_t matches) {
+  Word word;
+  size_t guesses = 0, wins = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t m = 0; m < matches; ++m) {
+    word.initialize(phrase);
+    // Guess every letter twice, so repeats are exercised too.
+    for (int pass = 0; pass < 2; ++pass) {
+      for (int l = 0; l < alphabet::N_LETTERS; ++l) {
+        auto g = static_cast<wchar_t>(alphabet::letter(l));
+        guesses++;
+        switch (word.guess(g)) {
+          case HangmanWord::guess_e::REPEATED: break;
+          case HangmanWord::guess_e::WRONG: word.add_wrong_guess(g); break;
+          case HangmanWord::guess_e::CORRECT:
+            word.add_correct_guess(g);
+            word.unmasked_char(g);
+            break;
+        }
+        if (word.all_unmasked()) { wins++; }
+      }
+    }
+  }
+  double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  std::cout << label << ": " << static_cast<double>(guesses) / secs << " guesses/s ("
+            << wins << " win checks passed)\n";
+}
+
+int main(int argc, char *argv[]) {
+  size_t length = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000;
+  size_t matches = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 2000;
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<int> letter(0, alphabet::N_LETTERS - 1);
+  std::wstring phrase;
+  for (size_t i = 0; i < length; ++i) { phrase += static_cast<wchar_t>(alphabet::letter(letter(rng))); }
+
+  run<LinearWord>("linear scan", phrase, matches);
+  run<HangmanWord>("bitmask    ", phrase, matches);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,115 @@
+/*!
+ * Heap allocations per guess.
+ * @file bench_guess_alloc.cpp
+ *
+ * Drives a GameController through a scripted match, one game loop
+ * iteration (process_events, update, render) per guess, and counts
+ * the calls to the global operator new made by its thread while the
+ * match is on; the journal's background fold may allocate meanwhile.
+ * Exits with failure if any guess allocated.
+ *
+ * Runs in a scratch directory of its own, with a one word dictionary.
+ * Frames are sent to /dev/null while the game runs.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "hangman_gm.h"
+
+static thread_local size_t g_allocations = 0;
+
+void *operator new(size_t n) {
+  g_allocations++;
+  if (void *p = std::malloc(n)) { return p; }
+  throw std::bad_alloc();
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+
+/// Discards everything written to it.
+class NullBuffer : public std::wstreambuf {
+protected:
+  int_type overflow(int_type c) override { return traits_type::not_eof(c); }
+  std::streamsize xsputn(const wchar_t *, std::streamsize n) override { return n; }
+};
+
+int main() {
+  namespace fs = std::filesystem;
+  fs::path dir = fs::temp_directory_path() / "hangman_guess_alloc";
+  fs::create_directories(dir);
+  fs::current_path(dir);
+  std::ofstream("words.csv") << "palavra,Categoria\nparalelepipedo,objeto\n";
+  std::ofstream("Players.txt").close();
+
+  // Name, hard dificult (the only tier of a one word dictionary), play,
+  // then wrong, right and repeated guesses that leave the word unsolved.
+  const wchar_t *guesses[] = {L"A", L"Z", L"E", L"A", L"L", L"X", L"P", L"Z", L"R", L"I"};
+  std::string script = "bob\n4\n3\n1\n";
+  for (const wchar_t *g : guesses) { script += static_cast<char>(g[0]) + std::string("\n"); }
+  // The game reads keys straight from standard input: feed it the script
+  // through a pipe, which holds all of it.
+  int keyboard = ::dup(STDIN_FILENO);
+  int script_pipe[2];
+  if (::pipe(script_pipe) != 0 ||
+      ::write(script_pipe[1], script.data(), script.size()) != static_cast<ssize_t>(script.size())) {
+    std::perror("pipe");
+    return EXIT_FAILURE;
+  }
+  ::close(script_pipe[1]);
+  ::dup2(script_pipe[0], STDIN_FILENO);
+  ::close(script_pipe[0]);
+  NullBuffer output;
+  std::wstreambuf *cout_buffer = std::wcout.rdbuf(&output);
+
+  // The renderer writes frames to the terminal itself.
+  std::fflush(stdout);
+  int terminal = ::dup(STDOUT_FILENO);
+  int null = ::open("/dev/null", O_WRONLY);
+  ::dup2(null, STDOUT_FILENO);
+
+  std::vector<size_t> counts;
+  counts.reserve(sizeof(guesses) / sizeof(guesses[0]));
+  {
+    GameController hg;
+    // STARTING, WELCOME, MAIN_MENU (dificult), DIFICULT, MAIN_MENU (play).
+    for (int i = 0; i < 5; ++i) {
+      hg.process_events();
+      hg.update();
+      hg.render();
+    }
+    for (size_t i = 0; i < sizeof(guesses) / sizeof(guesses[0]); ++i) {
+      size_t before = g_allocations;
+      hg.process_events();
+      hg.update();
+      hg.render();
+      counts.push_back(g_allocations - before);
+    }
+  }
+  ::dup2(keyboard, STDIN_FILENO);
+  ::close(keyboard);
+  std::wcout.rdbuf(cout_buffer);
+  ::dup2(terminal, STDOUT_FILENO);
+  ::close(terminal);
+  ::close(null);
+
+  bool ok = true;
+  for (size_t i = 0; i < counts.size(); ++i) {
+    std::fprintf(stdout, "guess %ls: %zu allocations\n", guesses[i], counts[i]);
+    ok = ok && counts[i] == 0;
+  }
+  std::fprintf(stdout, ok ? "OK: no allocations per guess\n" : "FAIL: guesses allocated\n");
+  fs::current_path(fs::temp_directory_path());
+  fs::remove_all(dir);
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,101 @@
+/*!
+ * Benchmark for the leaderboard.
+ * @file bench_leaderboard.cpp
+ *
+ * Compares showing the scoreboard by copying every player into a vector
+ * and sorting it, as the game once did, with reading the top 5 and one
+ * player's rank from the Leaderboard, which is kept in order as players
+ * change. Also times a page deep into each of the other orders.
+ *
+ * Usage: bench_leaderboard [n_players] [n_words_per_player]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "leaderboard.h"
+#include "player.h"
+
+template <typename Fn> static double time_ms(Fn &&fn) {
+  auto start = std::chrono::steady_clock::now();
+  fn();
+  auto stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+int main(int argc, char *argv[]) {
+  size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+  size_t n_words = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 50;
+  std::mt19937 rng(42);
+  std::unordered_map<std::wstring, Player> players;
+  for (size_t i = 0; i < n; ++i) {
+    std::wstring name = L"player" + std::to_wstring(i);
+    Player player(name);
+    player.increase_score(rng() % 100000);
+    for (size_t g = rng() % 20; g > 0; --g) {
+      if (rng() % 3 == 0) { player.add_hard_played(); }
+      if (rng() % 2 == 0) { player.add_wins(); } else { player.add_loses(); }
+    }
+    for (size_t w = 0; w < n_words; ++w) { player.add_word(static_cast<uint32_t>(rng() % 100000)); }
+    players.emplace(name, std::move(player));
+  }
+  std::wstring me = L"player" + std::to_wstring(n / 2);
+  std::cout << n << " players, " << n_words << " played words each\n";
+
+  size_t sink = 0;
+  double sorted = time_ms([&] {
+    std::vector<std::pair<std::wstring, Player>> all(players.begin(), players.end());
+    std::sort(all.begin(), all.end(), [](const auto &a, const auto &b) {
+      return a.second.score() > b.second.score();
+    });
+    sink += all.front().second.score();
+  });
+  std::cout << "copy + sort all, per view:    " << sorted << " ms\n";
+
+  Leaderboard board;
+  double build = time_ms([&] {
+    for (const auto &[name, player] : players) { board.update(player); }
+  });
+  std::cout << "leaderboard, build (once):    " << build << " ms\n";
+
+  const size_t views = 10000;
+  double view = time_ms([&] {
+    for (size_t i = 0; i < views; ++i) {
+      board.top(5, [&sink](size_t rank, const Leaderboard::Entry &e) { sink += rank + e.score; });
+      sink += board.rank(Leaderboard::order_e::SCORE, me);
+    }
+  }) / views;
+  std::cout << "leaderboard, top 5 + rank:    " << view * 1000 << " us\n";
+
+  const char *names[Leaderboard::N_ORDERS] = {"score", "hard", "win rate", "words"};
+  for (size_t o = 0; o < Leaderboard::N_ORDERS; ++o) {
+    auto order = static_cast<Leaderboard::order_e>(o);
+    double paged = time_ms([&] {
+      for (size_t i = 0; i < views; ++i) {
+        board.page(order, n / 2, 10, [&sink](size_t rank, const Leaderboard::Entry &) { sink += rank; });
+      }
+    }) / views;
+    std::cout << "leaderboard, mid page of 10 by " << names[o] << ": " << paged * 1000 << " us\n";
+  }
+
+  const size_t updates = 100000;
+  std::vector<Player *> order;
+  order.reserve(players.size());
+  for (auto &[name, player] : players) { order.push_back(&player); }
+  double update = time_ms([&] {
+    for (size_t i = 0; i < updates; ++i) {
+      Player &player = *order[rng() % order.size()];
+      player.increase_score(10);
+      board.update(player);
+    }
+  }) / updates;
+  std::cout << "leaderboard, score change:    " << update * 1000 << " us\n";
+  return sink == 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
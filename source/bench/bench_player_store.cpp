@@ -0,0 +1,144 @@
+/*!
+ * Benchmark for the player store.
+ * @file bench_player_store.cpp
+ *
+ * Generates a synthetic Players.txt and compares the text format with
+ * the binary player store:
+ *  - getting one player ready to play: parsing every record into a
+ *    map, as the game once did, against opening the store and loading
+ *    only that player;
+ *  - throughput: writing and reading every player, and updating every
+ *    player's counters (a rewrite of the whole text file, against
+ *    stores into the mapping).
+ *
+ * First it checks that an old record, listing its played words as the
+ * game used to write them, accents left lower case ("CAçADOR"), is
+ * imported with every word found; and exits with failure if not.
+ *
+ * Usage: bench_player_store [n_players]
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "dictionary.h"
+#include "player.h"
+#include "player_store.h"
+
+template <typename Fn> static double time_ms(Fn &&fn) {
+  auto start = std::chrono::steady_clock::now();
+  fn();
+  auto stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+static void report(const char *label, double ms, size_t n) {
+  std::cout << label << ms << " ms";
+  if (n > 1) { std::cout << " (" << n / ms * 1000 << " players/s)"; }
+  std::cout << '\n';
+}
+
+/// Return whether an old record with accented words is read with all its words.
+static bool check_legacy_words() {
+  const char *csv = "bench_players_words.csv";
+  {
+    std::ofstream out(csv);
+    out << "palavra,Categoria\ncasa,lugar\ncaçador,profissão\npão,comida\n";
+  }
+  Dictionary dictionary;
+  bool built = dictionary.build(csv);
+  std::remove(csv);
+  std::wistringstream file(L"velho\n12\n1\n1\n0\n2\nCAçADOR\nPãO\n1\n1\n---\n");
+  Player player;
+  player.read_file(file, dictionary);
+  return built && player.has_played(dictionary.find_word("CAÇADOR")) && player.has_played(dictionary.find_word("PÃO")) &&
+         !player.has_played(dictionary.find_word("CASA"));
+}
+
+int main(int argc, char *argv[]) {
+  size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+  if (!check_legacy_words()) {
+    std::cerr << "FAIL: accented words of an old record were lost\n";
+    return EXIT_FAILURE;
+  }
+  const char *text = "bench_players.txt";
+  const char *data = "bench_players.dat";
+  const char *index = "bench_players.idx";
+  {
+    std::ofstream out(text);
+    for (size_t i = 0; i < n; ++i) {
+      out << "player" << i << '\n' << i % 5000 << "\n3\n2\n1\n6\n#" << i % 40 << '-'
+          << i % 40 + 5 << ",120\n4\n2\n---\n";
+    }
+  }
+  std::remove(data);
+  std::remove(index);
+  Dictionary dictionary;
+  std::wstring wanted = L"player" + std::to_wstring(n / 2);
+
+  std::cout << "== one player, " << n << " in the file\n";
+  std::vector<Player> players;
+  players.reserve(n);
+  double full = time_ms([&] {
+    std::wifstream file(text);
+    std::unordered_map<std::wstring, size_t> by_name;
+    while (file.peek() != WEOF) {
+      players.emplace_back().read_file(file, dictionary);
+      by_name.emplace(players.back().name(), players.size() - 1);
+    }
+  });
+  report("text, parse every player:    ", full, 1);
+
+  double convert = time_ms([&] {
+    PlayerStore store(data, index);
+    store.open();
+    store.import_text(text, dictionary);
+  });
+  report("store, import (once):         ", convert, 1);
+
+  bool found = false;
+  double lazy = time_ms([&] {
+    PlayerStore store(data, index);
+    store.open();
+    Player player;
+    found = store.load(wanted, player);
+  });
+  report(found ? "store, open + load one:       " : "store, NOT FOUND:             ", lazy, 1);
+
+  std::cout << "== throughput\n";
+  report("text, write all:              ", time_ms([&] {
+           std::wofstream file(text, std::ios::trunc);
+           for (const Player &p : players) { p.write_file(file); }
+         }), n);
+  report("text, read all:               ", time_ms([&] {
+           std::wifstream file(text);
+           Player player;
+           while (file.peek() != WEOF) { player.read_file(file, dictionary); }
+         }), n);
+
+  PlayerStore store(data, index);
+  store.open();
+  size_t seen = 0;
+  double read_all = time_ms([&] { store.for_each([&seen](const Player &) { ++seen; }); });
+  report("store, read all:              ", read_all, seen);
+  report("store, update all in place:   ", time_ms([&] {
+           for (Player &p : players) {
+             p.add_wins();
+             p.increase_score(10);
+             store.save(p);
+           }
+           store.sync();
+         }), n);
+
+  std::remove(text);
+  std::remove(data);
+  std::remove(index);
+  return EXIT_SUCCESS;
+}
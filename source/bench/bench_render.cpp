@@ -0,0 +1,155 @@
+/*!
+ * Benchmark for drawing a frame.
+ * @file bench_render.cpp
+ *
+ * Drives a GameController into a match, then times drawing the play
+ * screen two ways, with the screen sent to /dev/null:
+ *  - as the game once did: running `clear` through system(), then
+ *    writing the screen line by line, flushing at every std::endl;
+ *  - with render(), which composes the screen in a Frame and shows it
+ *    with one write.
+ * Also reports the writes made per frame by each, and the time to draw
+ * the play screen when nothing on it changed, which is mostly the time
+ * display_play_screen() takes to compose it. Then it plays on,
+ * comparing the bytes sent per guess by render(), which only sends the
+ * lines that changed, with the size of the whole screen.
+ *
+ * Runs in a scratch directory of its own, with a one word dictionary.
+ *
+ * Usage: bench_render [n_frames]
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "hangman_gm.h"
+
+template <typename Fn> static double time_ms(Fn &&fn) {
+  auto start = std::chrono::steady_clock::now();
+  fn();
+  auto stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+int main(int argc, char *argv[]) {
+  size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200;
+  namespace fs = std::filesystem;
+  fs::path dir = fs::temp_directory_path() / "hangman_render";
+  fs::create_directories(dir);
+  fs::current_path(dir);
+  std::ofstream("words.csv") << "palavra,Categoria\nparalelepipedo,objeto\n";
+  std::ofstream("Players.txt").close();
+  setenv("TERM", "xterm", 0);
+
+  // Name, hard dificult, play, then a few guesses.
+  const wchar_t *guesses[] = {L"L", L"X", L"P", L"Z", L"R", L"I"};
+  std::string script = "bob\n4\n3\n1\nA\nZ\nE\n";
+  for (const wchar_t *g : guesses) { script += static_cast<char>(g[0]) + std::string("\n"); }
+  // The game reads keys straight from standard input: feed it the script
+  // through a pipe, which holds all of it.
+  int keyboard = ::dup(STDIN_FILENO);
+  int script_pipe[2];
+  if (::pipe(script_pipe) != 0 ||
+      ::write(script_pipe[1], script.data(), script.size()) != static_cast<ssize_t>(script.size())) {
+    std::perror("pipe");
+    return EXIT_FAILURE;
+  }
+  ::close(script_pipe[1]);
+  ::dup2(script_pipe[0], STDIN_FILENO);
+  ::close(script_pipe[0]);
+
+  std::fflush(stdout);
+  int terminal = ::dup(STDOUT_FILENO);
+  int null = ::open("/dev/null", O_WRONLY);
+  std::string frame_path = (dir / "frame").string();
+  int capture = ::open(frame_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+  double legacy = 0, framed = 0, unchanged = 0;
+  size_t lines = 0, diff_bytes = 0, full_bytes = 0;
+  // Bytes written to the capture file by one call.
+  auto bytes_of = [capture](auto &&draw) {
+    off_t before = ::lseek(capture, 0, SEEK_END);
+    draw();
+    return static_cast<size_t>(::lseek(capture, 0, SEEK_END) - before);
+  };
+  {
+    GameController hg;
+    ::dup2(null, STDOUT_FILENO);
+    for (int i = 0; i < 8; ++i) {
+      hg.process_events();
+      hg.update();
+      hg.render();
+    }
+    // One frame of the play screen, as text.
+    ::dup2(capture, STDOUT_FILENO);
+    hg.redraw();
+    hg.render();
+    ::dup2(null, STDOUT_FILENO);
+    std::ifstream file(frame_path, std::ios::binary);
+    std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    text.erase(0, Frame::CLEAR.size());
+    std::vector<std::string> screen;
+    std::istringstream split(text);
+    for (std::string line; std::getline(split, line);) { screen.push_back(line); }
+    lines = screen.size();
+
+    legacy = time_ms([&] {
+      for (size_t i = 0; i < n; ++i) {
+        if (std::system("clear") != 0) { break; }
+        for (const std::string &line : screen) { std::cout << line << std::endl; }
+      }
+    }) / n;
+    size_t frames = n * 100;
+    framed = time_ms([&] {
+      for (size_t i = 0; i < frames; ++i) {
+        hg.redraw();
+        hg.render();
+      }
+    }) / frames;
+    unchanged = time_ms([&] {
+      for (size_t i = 0; i < frames; ++i) { hg.render(); }
+    }) / frames;
+
+    // Each guess, sent as a diff and then whole.
+    ::dup2(capture, STDOUT_FILENO);
+    for (size_t i = 0; i < sizeof(guesses) / sizeof(guesses[0]); ++i) {
+      hg.process_events();
+      hg.update();
+      diff_bytes += bytes_of([&] { hg.render(); });
+      full_bytes += bytes_of([&] {
+        hg.redraw();
+        hg.render();
+      });
+    }
+    ::dup2(null, STDOUT_FILENO);
+  }
+  ::dup2(keyboard, STDIN_FILENO);
+  ::close(keyboard);
+  ::dup2(terminal, STDOUT_FILENO);
+  ::close(terminal);
+  ::close(null);
+  ::close(capture);
+
+  std::printf("play screen, %zu lines\n", lines);
+  std::printf("system(\"clear\") + endl per line: %10.2f us/frame, 1 child process + %zu writes\n",
+              legacy * 1000, lines);
+  std::printf("Frame, one write:                 %10.2f us/frame, 1 write\n", framed * 1000);
+  std::printf("speedup: %.0fx\n", legacy / framed);
+  std::printf("Frame, nothing changed:           %10.2f us/frame\n", unchanged * 1000);
+  size_t n_guesses = sizeof(guesses) / sizeof(guesses[0]);
+  std::printf("bytes per guess, whole screen:    %10zu\n", full_bytes / n_guesses);
+  std::printf("bytes per guess, changed lines:   %10zu\n", diff_bytes / n_guesses);
+  fs::current_path(fs::temp_directory_path());
+  fs::remove_all(dir);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,245 @@
+/*!
+ * Scaling of the work stealing scheduler.
+ * @file bench_scheduler.cpp
+ *
+ * Plays many sessions at once on the Scheduler (see scheduler.h), each
+ * a task that plays one whole match per run, guessing letters from the
+ * most to the least frequent, and asks to run again until it played
+ * its share. The same load is run on 1, 2, 4, ... workers, up to the
+ * number of cores (or the number given), and the matches per second
+ * and the speedup over one worker are printed for each. The last match
+ * played stops the scheduler.
+ *
+ * Then the sessions are driven the way the server drives them: a feeder
+ * thread, standing for the network, posts each idle session (one input
+ * arrived) while run() is running, and the session handles that one
+ * input and waits to be posted again. The inputs per second and the
+ * delay from a post to its run are printed, on as many workers.
+ *
+ * The sessions share one dictionary and one leaderboard, read only, as
+ * in the server; each keeps its changes to itself.
+ *
+ * Usage: bench_scheduler [max_workers] [n_sessions] [matches_per_session]
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "../utils/scheduler.h"
+#include "leaderboard.h"
+#include "session.h"
+#include "shared_dictionary.h"
+
+/// Letters guessed, most frequent in Portuguese first.
+static constexpr std::wstring_view LETTERS = L"AEOSRINDMUTCLPVGHQBFZJXKWY";
+
+/// A player, playing match after match.
+class Play : public Scheduler::Task {
+  Session m_session;              //!< The player's session.
+  size_t m_left;                  //!< Matches left to play.
+  Scheduler &m_scheduler;         //!< Stopped by the last match played.
+  std::atomic<size_t> &m_playing; //!< Sessions with matches left to play.
+
+public:
+  size_t changes = 0; //!< Changes the session reported, as a host would save them.
+  size_t inputs = 0;  //!< Inputs handled.
+
+  Play(const SharedDictionary &words, const Leaderboard &leaderboard, size_t id, size_t matches, Scheduler &scheduler,
+       std::atomic<size_t> &playing)
+      : m_session{words, leaderboard, Player(L"player" + std::to_wstring(id)), id}, m_left{matches},
+        m_scheduler{scheduler}, m_playing{playing} {}
+
+  bool run() override {
+    key(L'1');
+    if (m_session.screen() == Session::screen_e::NO_WORDS) {
+      line(L"yes");
+      key(L'1');
+    }
+    for (size_t i = 0; i < LETTERS.size() && m_session.match().status() == Match::status_e::ON; ++i) {
+      key(LETTERS[i]);
+    }
+    key(L'\n');
+    if (--m_left != 0) { return true; }
+    if (m_playing.fetch_sub(1) == 1) { m_scheduler.stop(); }
+    return false;
+  }
+
+private:
+  void key(wchar_t key) {
+    Session::Input input;
+    input.key = key;
+    handle(input);
+  }
+  void line(std::wstring_view line) {
+    Session::Input input;
+    input.line = line;
+    handle(input);
+  }
+  void handle(const Session::Input &input) {
+    m_session.handle(input);
+    ++inputs;
+    m_session.flush_changes([this](const Session::Change &) { ++changes; });
+  }
+};
+
+/// A player whose every input arrives from another thread.
+class Posted : public Scheduler::Task {
+  using Clock = std::chrono::steady_clock;
+
+  Session m_session;  //!< The player's session.
+  size_t m_guess = 0; //!< Next letter to guess in the match.
+
+public:
+  std::atomic<bool> idle{true}; //!< Whether the session waits for input; set by the worker, cleared by the feeder.
+  Clock::time_point posted;     //!< When the input was posted.
+  std::vector<double> delays;   //!< Microseconds from each post to its run.
+
+  Posted(const SharedDictionary &words, const Leaderboard &leaderboard, size_t id)
+      : m_session{words, leaderboard, Player(L"posted" + std::to_wstring(id)), id} {}
+
+  bool run() override {
+    delays.push_back(std::chrono::duration<double, std::micro>(Clock::now() - posted).count());
+    Session::Input input;
+    if (m_session.screen() == Session::screen_e::NO_WORDS) {
+      input.line = L"yes";
+    } else if (m_session.screen() != Session::screen_e::PLAYING) {
+      input.key = L'1';
+      m_guess = 0;
+    } else if (m_session.match().status() == Match::status_e::ON && m_guess < LETTERS.size()) {
+      input.key = LETTERS[m_guess++];
+    } else {
+      input.key = L'\n';
+    }
+    m_session.handle(input);
+    m_session.flush_changes([](const Session::Change &) {});
+    idle.store(true, std::memory_order_release);
+    return false;
+  }
+};
+
+/**
+ * @brief Post inputs to the sessions from another thread while the
+ * scheduler runs, until `n_inputs` were handled.
+ *
+ * @return false if an input was lost.
+ */
+static bool run_posted(const SharedDictionary &words, const Leaderboard &leaderboard, size_t n_workers,
+                       size_t n_sessions, size_t n_inputs) {
+  std::vector<std::unique_ptr<Posted>> posted;
+  for (size_t i = 0; i < n_sessions; ++i) { posted.push_back(std::make_unique<Posted>(words, leaderboard, i)); }
+  Scheduler scheduler(n_workers);
+  std::thread feeder([&] {
+    size_t sent = 0;
+    while (sent < n_inputs) {
+      bool any = false;
+      for (size_t i = 0; i < n_sessions && sent < n_inputs; ++i) {
+        Posted &session = *posted[i];
+        if (!session.idle.load(std::memory_order_acquire)) { continue; }
+        session.idle.store(false, std::memory_order_relaxed);
+        session.posted = std::chrono::steady_clock::now();
+        scheduler.post(session);
+        ++sent;
+        any = true;
+      }
+      if (!any) { std::this_thread::yield(); }
+    }
+    // Every input handled: every session idle again.
+    for (const auto &session : posted) {
+      while (!session->idle.load(std::memory_order_acquire)) { std::this_thread::yield(); }
+    }
+    scheduler.stop();
+  });
+  auto start = std::chrono::steady_clock::now();
+  scheduler.run();
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  feeder.join();
+
+  std::vector<double> delays;
+  for (const auto &session : posted) { delays.insert(delays.end(), session->delays.begin(), session->delays.end()); }
+  std::sort(delays.begin(), delays.end());
+  auto at = [&](double q) { return delays[static_cast<size_t>(q * static_cast<double>(delays.size() - 1))]; };
+  std::printf("%8zu %12.0f %11.1f %11.1f %9zu\n", n_workers, static_cast<double>(delays.size()) / seconds, at(0.5),
+              at(0.99), scheduler.steals());
+  if (delays.size() != n_inputs || scheduler.runs() != n_inputs) {
+    std::fprintf(stderr, "FAIL: %zu inputs handled, %zu posted\n", delays.size(), n_inputs);
+    return false;
+  }
+  return true;
+}
+
+int main(int argc, char *argv[]) {
+  size_t max_workers = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : std::thread::hardware_concurrency();
+  size_t n_sessions = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 4096;
+  size_t n_matches = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 25;
+  max_workers = std::max<size_t>(max_workers, 1);
+
+  namespace fs = std::filesystem;
+  fs::path dir = fs::temp_directory_path() / "hangman_scheduler";
+  fs::create_directories(dir);
+  fs::path csv = dir / "words.csv";
+  {
+    // Made up words, 5 to 12 letters long, over a few categories.
+    std::mt19937 rng(7);
+    std::ofstream out(csv);
+    out << "palavra,Categoria\n";
+    for (size_t i = 0; i < 5000; ++i) {
+      std::string word(5 + rng() % 8, 'A');
+      for (char &c : word) { c = static_cast<char>('A' + rng() % 26); }
+      out << word << ",categoria" << i % 8 << '\n';
+    }
+  }
+  SharedDictionary words;
+  if (!words.load(csv.string())) {
+    std::fprintf(stderr, "Unable to build the dictionary.\n");
+    return EXIT_FAILURE;
+  }
+  Leaderboard leaderboard;
+
+  std::printf("%zu sessions x %zu matches; %u cores\n", n_sessions, n_matches, std::thread::hardware_concurrency());
+  std::printf("%8s %12s %12s %9s %11s %9s\n", "workers", "matches/s", "inputs/s", "speedup", "efficiency", "steals");
+  // 1, 2, 4, ..., and max_workers itself.
+  std::vector<size_t> sweep;
+  for (size_t n = 1; n < max_workers; n *= 2) { sweep.push_back(n); }
+  sweep.push_back(max_workers);
+  double base = 0;
+  for (size_t n_workers : sweep) {
+    std::vector<std::unique_ptr<Play>> plays;
+    Scheduler scheduler(n_workers);
+    std::atomic<size_t> playing{n_sessions};
+    for (size_t i = 0; i < n_sessions; ++i) {
+      plays.push_back(std::make_unique<Play>(words, leaderboard, i, n_matches, scheduler, playing));
+      scheduler.submit(*plays.back());
+    }
+    auto start = std::chrono::steady_clock::now();
+    scheduler.run();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    size_t inputs = 0;
+    for (const auto &play : plays) { inputs += play->inputs; }
+    double rate = static_cast<double>(n_sessions * n_matches) / seconds;
+    if (n_workers == 1) { base = rate; }
+    std::printf("%8zu %12.0f %12.0f %8.2fx %10.0f%% %9zu\n", n_workers, rate, static_cast<double>(inputs) / seconds,
+                rate / base, 100 * rate / base / static_cast<double>(n_workers), scheduler.steals());
+    if (scheduler.runs() != n_sessions * n_matches) {
+      std::fprintf(stderr, "FAIL: %zu runs, expected %zu\n", scheduler.runs(), n_sessions * n_matches);
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::printf("\nposted from another thread: %zu sessions, %zu inputs\n", n_sessions, n_sessions * n_matches);
+  std::printf("%8s %12s %11s %11s %9s\n", "workers", "inputs/s", "p50 us", "p99 us", "steals");
+  for (size_t n_workers : sweep) {
+    if (!run_posted(words, leaderboard, n_workers, n_sessions, n_sessions * n_matches)) { return EXIT_FAILURE; }
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,106 @@
+/*!
+ * Memory held by idle sessions.
+ * @file bench_session_memory.cpp
+ *
+ * Starts many sessions and leaves them idle, first at the main menu and
+ * then in the middle of a match, waiting for the next key, as the
+ * server holds players between their inputs. Prints what each costs,
+ * measured as the growth of the heap in use: the Session object itself,
+ * its suspended coroutine frames and what it holds (the player, the
+ * word pickers); and, for comparison, the stack a thread per player
+ * would reserve.
+ *
+ * Usage: bench_session_memory [n_sessions]
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <malloc.h>
+#include <memory>
+#include <new>
+#include <pthread.h>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "leaderboard.h"
+#include "session.h"
+#include "shared_dictionary.h"
+
+static size_t g_allocations = 0;
+
+void *operator new(size_t n) {
+  g_allocations++;
+  if (void *p = std::malloc(n)) { return p; }
+  throw std::bad_alloc();
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+
+/// Return the bytes of heap in use.
+static size_t heap_in_use() { return mallinfo2().uordblks; }
+
+/// Feed a key to a session.
+static void press(Session &session, wchar_t key) {
+  Session::Input input;
+  input.key = key;
+  session.handle(input);
+  session.flush_changes([](const Session::Change &) {});
+}
+
+int main(int argc, char *argv[]) {
+  size_t n_sessions = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+
+  namespace fs = std::filesystem;
+  fs::path dir = fs::temp_directory_path() / "hangman_session_memory";
+  fs::create_directories(dir);
+  fs::path csv = dir / "words.csv";
+  {
+    std::mt19937 rng(7);
+    std::ofstream out(csv);
+    out << "palavra,Categoria\n";
+    for (size_t i = 0; i < 5000; ++i) {
+      std::string word(5 + rng() % 8, 'A');
+      for (char &c : word) { c = static_cast<char>('A' + rng() % 26); }
+      out << word << ",categoria" << i % 8 << '\n';
+    }
+  }
+  SharedDictionary words;
+  if (!words.load(csv.string())) {
+    std::fprintf(stderr, "Unable to build the dictionary.\n");
+    return EXIT_FAILURE;
+  }
+  Leaderboard leaderboard;
+
+  std::vector<std::unique_ptr<Session>> sessions;
+  sessions.reserve(n_sessions);
+  size_t heap = heap_in_use();
+  size_t allocations = g_allocations;
+  for (size_t i = 0; i < n_sessions; ++i) {
+    sessions.push_back(std::make_unique<Session>(words, leaderboard, Player(L"p" + std::to_wstring(i)), i));
+  }
+  double at_menu = static_cast<double>(heap_in_use() - heap) / static_cast<double>(n_sessions);
+  double menu_allocations = static_cast<double>(g_allocations - allocations) / static_cast<double>(n_sessions);
+
+  for (auto &session : sessions) {
+    press(*session, L'1');
+    press(*session, L'A');
+  }
+  double in_match = static_cast<double>(heap_in_use() - heap) / static_cast<double>(n_sessions);
+  double match_allocations = static_cast<double>(g_allocations - allocations) / static_cast<double>(n_sessions);
+
+  pthread_attr_t attributes;
+  size_t stack = 0;
+  pthread_attr_init(&attributes);
+  pthread_attr_getstacksize(&attributes, &stack);
+  pthread_attr_destroy(&attributes);
+
+  std::printf("%zu idle sessions\n", n_sessions);
+  std::printf("per session, at the menu:         %8.0f bytes (%.1f allocations)\n", at_menu, menu_allocations);
+  std::printf("per session, in a match:          %8.0f bytes (%.1f allocations)\n", in_match, match_allocations);
+  std::printf("  of which the Session object:    %8zu bytes\n", sizeof(Session));
+  std::printf("stack of a thread per session:    %8zu bytes reserved\n", stack);
+  return EXIT_SUCCESS;
+}
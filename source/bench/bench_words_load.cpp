@@ -0,0 +1,115 @@
+/*!
+ * Startup benchmark for the words file loader.
+ * @file bench_words_load.cpp
+ *
+ * Generates a synthetic words file and loads it twice: once with the
+ * original getline/stringstream/wstring_convert loop and once through
+ * SharedDictionary::load(), as GameController::read_words_file() does.
+ * With no compiled dictionary next to the file, that maps it, scans it
+ * with words_csv and builds the dictionary image in memory, tiers and
+ * category postings included. Reports wall time and heap allocations
+ * for each.
+ *
+ * Usage: bench_words_load [n_entries]
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <codecvt>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <locale>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "shared_dictionary.h"
+
+// The shipped loader computes signatures on several threads.
+static std::atomic<size_t> g_allocations{0};
+
+void *operator new(size_t n) {
+  g_allocations++;
+  if (void *p = std::malloc(n)) { return p; }
+  throw std::bad_alloc();
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+
+struct Word {
+  std::wstring word;
+  std::vector<std::wstring> categories;
+};
+
+/// The loader as it was before the mapped scanner.
+static std::vector<Word> load_legacy(const char *path) {
+  std::vector<Word> all_words;
+  std::ifstream file(path);
+  std::string line;
+  std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+  std::getline(file, line);
+  while (std::getline(file, line)) {
+    std::stringstream ss(line);
+    std::string palavra, categoria;
+    std::vector<std::wstring> categorias;
+    std::getline(ss, palavra, ',');
+    std::transform(palavra.begin(), palavra.end(), palavra.begin(),
+                   [](unsigned char c) { return std::toupper(c); });
+    std::wstring wword = converter.from_bytes(palavra);
+    while (std::getline(ss, categoria, ',')) {
+      std::transform(categoria.begin(), categoria.end(), categoria.begin(),
+                     [](unsigned char c) { return std::toupper(c); });
+      categorias.push_back(converter.from_bytes(categoria));
+    }
+    all_words.push_back({wword, categorias});
+  }
+  return all_words;
+}
+
+/// The shipped loader, as the game calls it.
+static std::unique_ptr<SharedDictionary> load_shipped(const char *path) {
+  auto words = std::make_unique<SharedDictionary>();
+  if (!words->load(path)) {
+    std::cerr << "Unable to load " << path << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+  return words;
+}
+
+/// Return the number of words loaded.
+static size_t n_words(const std::vector<Word> &words) { return words.size(); }
+static size_t n_words(const std::unique_ptr<SharedDictionary> &words) { return words->current()->size(); }
+
+template <typename Fn> static void run(const char *label, Fn &&load) {
+  g_allocations = 0;
+  auto start = std::chrono::steady_clock::now();
+  auto words = load();
+  auto stop = std::chrono::steady_clock::now();
+  size_t allocations = g_allocations;
+  std::cout << label << ": " << n_words(words) << " words in "
+            << std::chrono::duration<double, std::milli>(stop - start).count()
+            << " ms, " << allocations << " allocations\n";
+}
+
+int main(int argc, char *argv[]) {
+  size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+  const char *path = "bench_words.csv";
+  {
+    static const char *categories[] = {"pessoas", "lugar", "objeto,arte", "conceito",
+                                       "fruta,comida", "construcao,lugar"};
+    std::ofstream out(path);
+    out << "palavra,Categoria\n";
+    for (size_t i = 0; i < n; ++i) {
+      out << "palavra" << i << "ção," << categories[i % 6] << '\n';
+    }
+  }
+  run("legacy getline", [&] { return load_legacy(path); });
+  run("shipped loader", [&] { return load_shipped(path); });
+  std::remove(path);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,73 @@
+#ifndef ALPHABET_H
+#define ALPHABET_H
+/*!
+ * Game alphabet.
+ * @file alphabet.h
+ *
+ * Maps the (upper case) letters of the game, the latin alphabet plus
+ * the Portuguese accented letters and Ç, to small indices so that sets
+ * of letters fit in a single 64-bit mask, and folds accented letters
+ * onto their plain counterpart ('Ã' -> 'A', 'Ç' -> 'C') for matching.
+ * Everything here is built at compile time.
+ */
+
+#include <array>
+#include <cstdint>
+
+namespace alphabet {
+/// Set of letters, one bit per letter index.
+using mask_t = uint64_t;
+
+/// Accented letters, in index order after 'A'..'Z'.
+static constexpr std::array<char32_t, 13> ACCENTED{
+    U'Á', U'À', U'Â', U'Ã', U'É', U'Ê', U'Í', U'Ó', U'Ô', U'Õ', U'Ú', U'Ü', U'Ç'};
+
+/// Unaccented letter each accented letter folds to.
+static constexpr std::array<char32_t, 13> FOLDED{
+    U'A', U'A', U'A', U'A', U'E', U'E', U'I', U'O', U'O', U'O', U'U', U'U', U'C'};
+
+/// Number of letters in the alphabet.
+static constexpr int N_LETTERS = 26 + static_cast<int>(ACCENTED.size());
+static_assert(N_LETTERS <= 64, "letter sets must fit in mask_t");
+
+/// Value used for code points that are not letters.
+static constexpr int8_t NOT_A_LETTER = -1;
+
+namespace detail {
+constexpr std::array<int8_t, 256> make_latin1_table(bool folded) {
+  std::array<int8_t, 256> table{};
+  for (auto &entry : table) { entry = NOT_A_LETTER; }
+  for (int c = 'A'; c <= 'Z'; ++c) { table[c] = static_cast<int8_t>(c - 'A'); }
+  for (size_t i = 0; i < ACCENTED.size(); ++i) {
+    table[ACCENTED[i]] = static_cast<int8_t>(folded ? FOLDED[i] - U'A' : 26 + i);
+  }
+  return table;
+}
+} // namespace detail
+
+/// Letter index of every Latin-1 code point, or NOT_A_LETTER.
+static constexpr std::array<int8_t, 256> LATIN1_INDEX = detail::make_latin1_table(false);
+
+/// Folded letter index of every Latin-1 code point, or NOT_A_LETTER.
+static constexpr std::array<int8_t, 256> LATIN1_FOLDED = detail::make_latin1_table(true);
+
+/// Return the index of an upper case letter, or NOT_A_LETTER.
+constexpr int index_of(char32_t c) { return c < 256 ? LATIN1_INDEX[c] : NOT_A_LETTER; }
+
+/// Return the index of the unaccented form of an upper case letter, or NOT_A_LETTER.
+constexpr int folded_index_of(char32_t c) { return c < 256 ? LATIN1_FOLDED[c] : NOT_A_LETTER; }
+
+/// Return the letter with a given index.
+constexpr char32_t letter(int index) {
+  return index < 26 ? static_cast<char32_t>(U'A' + index) : ACCENTED[index - 26];
+}
+
+/// Return the index of the unaccented letter a letter index folds to.
+constexpr int fold(int index) {
+  return index < 26 ? index : static_cast<int>(FOLDED[index - 26] - U'A');
+}
+
+/// Return the bit of a letter index.
+constexpr mask_t bit(int index) { return mask_t{1} << index; }
+} // namespace alphabet
+#endif
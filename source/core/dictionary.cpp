@@ -0,0 +1,387 @@
+/*!
+ * Dictionary class implementation.
+ *
+ * \file dictionary.cpp
+ */
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <sys/stat.h>
+
+#include "../utils/utf8.h"
+#include "dictionary.h"
+#include "words_csv.h"
+
+namespace {
+/// Upper-case `text` into the pool, returning where it landed.
+Dictionary::Span intern_text(std::string &pool, std::string_view text) {
+  Dictionary::Span span{static_cast<uint32_t>(pool.size()), 0};
+  const char *it = text.data();
+  const char *end = it + text.size();
+  while (it != end) {
+    utf8::encode(pool, utf8::to_upper(utf8::decode(it, end)));
+  }
+  span.length = static_cast<uint32_t>(pool.size()) - span.offset;
+  return span;
+}
+
+/// Round `n` up to a multiple of 4.
+uint32_t align4(size_t n) { return static_cast<uint32_t>((n + 3) & ~size_t{3}); }
+
+/// Round `n` up to a multiple of 8.
+uint32_t align8(size_t n) { return static_cast<uint32_t>((n + 7) & ~size_t{7}); }
+
+/// Run `fn(first, last, worker)` over [0, n) split across the hardware threads.
+template <typename Fn> void parallel_for(size_t n, size_t n_workers, Fn &&fn) {
+  std::vector<std::thread> threads;
+  size_t chunk = (n + n_workers - 1) / n_workers;
+  for (size_t w = 0; w < n_workers; ++w) {
+    size_t first = std::min(n, w * chunk);
+    size_t last = std::min(n, first + chunk);
+    threads.emplace_back([&fn, first, last, w] { fn(first, last, w); });
+  }
+  for (auto &t : threads) { t.join(); }
+}
+} // namespace
+
+std::vector<Dictionary::Signature> Dictionary::compute_signatures(const std::string &pool,
+                                                                  const std::vector<Span> &words) {
+  std::vector<Signature> signatures(words.size());
+  size_t n_workers = std::max(1u, std::thread::hardware_concurrency());
+  n_workers = std::min(n_workers, std::max<size_t>(1, words.size() / 4096));
+
+  // First pass: letter sets, and letter counts to get the corpus frequencies.
+  using counts_t = std::array<uint64_t, alphabet::N_LETTERS>;
+  std::vector<counts_t> counts(n_workers, counts_t{});
+  parallel_for(words.size(), n_workers, [&](size_t first, size_t last, size_t w) {
+    for (size_t id = first; id < last; ++id) {
+      alphabet::mask_t letters = 0;
+      const char *it = pool.data() + words[id].offset;
+      const char *end = it + words[id].length;
+      while (it != end) {
+        int index = alphabet::folded_index_of(utf8::decode(it, end));
+        if (index == alphabet::NOT_A_LETTER) { continue; }
+        letters |= alphabet::bit(index);
+        counts[w][index]++;
+      }
+      signatures[id].letters = letters;
+      signatures[id].distinct = static_cast<uint32_t>(__builtin_popcountll(letters));
+    }
+  });
+  counts_t total{};
+  uint64_t all_letters = 0;
+  for (const auto &c : counts) {
+    for (int l = 0; l < alphabet::N_LETTERS; ++l) {
+      total[l] += c[l];
+      all_letters += c[l];
+    }
+  }
+  std::array<float, alphabet::N_LETTERS> surprisal{};
+  for (int l = 0; l < alphabet::N_LETTERS; ++l) {
+    if (total[l] > 0) {
+      surprisal[l] = static_cast<float>(-std::log2(static_cast<double>(total[l]) / all_letters));
+    }
+  }
+
+  // Second pass: a word is as hard as the information in the letters left to find.
+  parallel_for(words.size(), n_workers, [&](size_t first, size_t last, size_t) {
+    for (size_t id = first; id < last; ++id) {
+      float rarity = 0;
+      for (alphabet::mask_t m = signatures[id].letters; m != 0; m &= m - 1) {
+        rarity += surprisal[__builtin_ctzll(m)];
+      }
+      signatures[id].rarity = rarity;
+    }
+  });
+  return signatures;
+}
+
+std::vector<uint8_t> Dictionary::classify(const std::vector<Signature> &signatures) {
+  // Split the corpus into thirds by rank of rarity: the lowest third is
+  // easy, the highest is hard. Ranking, rather than comparing with the
+  // rarity at each cut, keeps the thirds even when many words tie (a
+  // small corpus, or words that are anagrams of each other); ties are
+  // broken by id, so a build is repeatable.
+  size_t n = signatures.size();
+  std::vector<uint32_t> ranked(n);
+  for (uint32_t id = 0; id < n; ++id) { ranked[id] = id; }
+  std::stable_sort(ranked.begin(), ranked.end(),
+                   [&](uint32_t a, uint32_t b) { return signatures[a].rarity < signatures[b].rarity; });
+  std::vector<uint8_t> tiers(n);
+  for (size_t rank = 0; rank < n; ++rank) {
+    tiers[ranked[rank]] = rank < n / 3 ? EASY : (rank < 2 * n / 3 ? NORMAL : HARD);
+  }
+  return tiers;
+}
+
+bool Dictionary::file_stamp(const char *path, uint64_t &size, int64_t &mtime) {
+  struct stat st {};
+  if (::stat(path, &st) != 0) { return false; }
+  size = static_cast<uint64_t>(st.st_size);
+  mtime = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+  return true;
+}
+
+std::vector<uint32_t> Dictionary::compile(std::string_view csv, uint64_t source_size,
+                                          int64_t source_mtime) {
+  std::string pool;
+  std::vector<Span> words, word_categories, categories;
+  std::vector<uint32_t> category_ids;
+  std::unordered_map<std::string, uint32_t> category_index;
+
+  size_t n_entries = words_csv::count_entries(csv);
+  pool.reserve(csv.size());
+  words.reserve(n_entries);
+  word_categories.reserve(n_entries);
+
+  std::string name;
+  words_csv::for_each_entry(csv, [&](std::string_view word, std::string_view cats) {
+    words.push_back(intern_text(pool, word));
+    word_categories.push_back({static_cast<uint32_t>(category_ids.size()), 0});
+    while (!cats.empty()) {
+      std::string_view field = words_csv::next_field(cats);
+      name.clear();
+      const char *it = field.data();
+      const char *end = it + field.size();
+      while (it != end) { utf8::encode(name, utf8::to_upper(utf8::decode(it, end))); }
+      auto [pos, inserted] =
+          category_index.try_emplace(name, static_cast<uint32_t>(categories.size()));
+      if (inserted) {
+        Span span{static_cast<uint32_t>(pool.size()), static_cast<uint32_t>(name.size())};
+        pool += name;
+        categories.push_back(span);
+      }
+      auto first = category_ids.begin() + word_categories.back().offset;
+      if (std::find(first, category_ids.end(), pos->second) != category_ids.end()) {
+        continue; // Same category listed twice for this word.
+      }
+      category_ids.push_back(pos->second);
+    }
+    word_categories.back().length =
+        static_cast<uint32_t>(category_ids.size()) - word_categories.back().offset;
+  });
+
+  std::vector<Signature> signatures = compute_signatures(pool, words);
+  std::vector<uint8_t> word_tier = classify(signatures);
+
+  std::vector<uint32_t> tiers[N_TIERS];
+  std::vector<std::vector<uint32_t>> postings(categories.size() * N_TIERS); // [category][tier]
+  for (uint32_t id = 0; id < words.size(); ++id) {
+    tiers[word_tier[id]].push_back(id);
+    const Span &cats = word_categories[id];
+    for (uint32_t i = cats.offset; i < cats.offset + cats.length; ++i) {
+      postings[category_ids[i] * N_TIERS + word_tier[id]].push_back(id);
+    }
+  }
+
+  std::vector<uint32_t> by_text(words.size());
+  for (uint32_t id = 0; id < words.size(); ++id) { by_text[id] = id; }
+  auto text_of = [&](uint32_t id) {
+    return std::string_view(pool.data() + words[id].offset, words[id].length);
+  };
+  std::sort(by_text.begin(), by_text.end(),
+            [&](uint32_t a, uint32_t b) { return text_of(a) < text_of(b); });
+
+  std::vector<Span> posting_spans;
+  std::vector<uint32_t> posting_ids;
+  posting_spans.reserve(postings.size());
+  for (const auto &list : postings) {
+    posting_spans.push_back({static_cast<uint32_t>(posting_ids.size()),
+                             static_cast<uint32_t>(list.size())});
+    posting_ids.insert(posting_ids.end(), list.begin(), list.end());
+  }
+
+  Header header{};
+  std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = VERSION;
+  header.source_size = source_size;
+  header.source_mtime = source_mtime;
+  header.n_words = static_cast<uint32_t>(words.size());
+  header.n_categories = static_cast<uint32_t>(categories.size());
+  header.n_category_ids = static_cast<uint32_t>(category_ids.size());
+  header.pool_size = static_cast<uint32_t>(pool.size());
+
+  uint32_t offset = align4(sizeof(Header));
+  header.words_off = offset;
+  offset += align4(words.size() * sizeof(Span));
+  header.word_categories_off = offset;
+  offset += align4(word_categories.size() * sizeof(Span));
+  header.category_ids_off = offset;
+  offset += align4(category_ids.size() * sizeof(uint32_t));
+  header.categories_off = offset;
+  offset += align4(categories.size() * sizeof(Span));
+  for (size_t t = 0; t < N_TIERS; ++t) {
+    header.tier_size[t] = static_cast<uint32_t>(tiers[t].size());
+    header.tiers_off[t] = offset;
+    offset += align4(tiers[t].size() * sizeof(uint32_t));
+  }
+  offset = align8(offset);
+  header.signatures_off = offset;
+  offset += align4(signatures.size() * sizeof(Signature));
+  header.n_posting_ids = static_cast<uint32_t>(posting_ids.size());
+  header.postings_off = offset;
+  offset += align4(posting_spans.size() * sizeof(Span));
+  header.posting_ids_off = offset;
+  offset += align4(posting_ids.size() * sizeof(uint32_t));
+  header.by_text_off = offset;
+  offset += align4(by_text.size() * sizeof(uint32_t));
+  header.pool_off = offset;
+  offset += align4(pool.size());
+  header.image_size = offset;
+
+  std::vector<uint32_t> image(offset / sizeof(uint32_t), 0);
+  auto *base = reinterpret_cast<char *>(image.data());
+  auto put = [base](uint32_t off, const void *src, size_t bytes) {
+    if (bytes > 0) { std::memcpy(base + off, src, bytes); }
+  };
+  put(0, &header, sizeof(header));
+  put(header.words_off, words.data(), words.size() * sizeof(Span));
+  put(header.word_categories_off, word_categories.data(), word_categories.size() * sizeof(Span));
+  put(header.category_ids_off, category_ids.data(), category_ids.size() * sizeof(uint32_t));
+  put(header.categories_off, categories.data(), categories.size() * sizeof(Span));
+  for (size_t t = 0; t < N_TIERS; ++t) {
+    put(header.tiers_off[t], tiers[t].data(), tiers[t].size() * sizeof(uint32_t));
+  }
+  put(header.signatures_off, signatures.data(), signatures.size() * sizeof(Signature));
+  put(header.postings_off, posting_spans.data(), posting_spans.size() * sizeof(Span));
+  put(header.posting_ids_off, posting_ids.data(), posting_ids.size() * sizeof(uint32_t));
+  put(header.by_text_off, by_text.data(), by_text.size() * sizeof(uint32_t));
+  put(header.pool_off, pool.data(), pool.size());
+  return image;
+}
+
+bool Dictionary::open(const char *path, const char *source_path) {
+  MappedFile file(path);
+  if (!file.is_open()) { return false; }
+  m_file = std::move(file);
+  m_owned.clear();
+  if (!attach(m_file.data(), m_file.size())) {
+    m_file.close();
+    return false;
+  }
+  uint64_t size;
+  int64_t mtime;
+  if (source_path != nullptr && file_stamp(source_path, size, mtime) &&
+      (size != m_header->source_size || mtime != m_header->source_mtime)) {
+    m_header = nullptr;
+    m_file.close();
+    return false;
+  }
+  return true;
+}
+
+bool Dictionary::build(const char *csv_path) {
+  MappedFile file(csv_path);
+  if (!file.is_open()) { return false; }
+  uint64_t size = 0;
+  int64_t mtime = 0;
+  file_stamp(csv_path, size, mtime);
+  m_file.close();
+  m_owned = compile(file.view(), size, mtime);
+  return attach(m_owned.data(), m_owned.size() * sizeof(uint32_t));
+}
+
+bool Dictionary::attach(const void *base, size_t size) {
+  m_header = nullptr;
+  const auto *header = static_cast<const Header *>(base);
+  if (size < sizeof(Header) || std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 ||
+      header->version != VERSION || header->image_size != size) {
+    return false;
+  }
+  auto fits = [size](uint32_t off, uint64_t count, size_t elem) {
+    return off % 4 == 0 && off <= size && count * elem <= size - off;
+  };
+  bool valid = fits(header->words_off, header->n_words, sizeof(Span)) &&
+               fits(header->word_categories_off, header->n_words, sizeof(Span)) &&
+               fits(header->category_ids_off, header->n_category_ids, sizeof(uint32_t)) &&
+               fits(header->categories_off, header->n_categories, sizeof(Span)) &&
+               fits(header->postings_off, uint64_t{header->n_categories} * N_TIERS, sizeof(Span)) &&
+               fits(header->signatures_off, header->n_words, sizeof(Signature)) &&
+               header->signatures_off % alignof(Signature) == 0 &&
+               fits(header->posting_ids_off, header->n_posting_ids, sizeof(uint32_t)) &&
+               fits(header->by_text_off, header->n_words, sizeof(uint32_t)) &&
+               fits(header->pool_off, header->pool_size, sizeof(char));
+  for (size_t t = 0; t < N_TIERS; ++t) {
+    valid = valid && fits(header->tiers_off[t], header->tier_size[t], sizeof(uint32_t));
+  }
+  if (!valid) { return false; }
+
+  // The sections fit; check what they point to, so a damaged file is
+  // rebuilt from the words file instead of read out of bounds.
+  const char *image = static_cast<const char *>(base);
+  auto spans_fit = [image](uint32_t off, uint64_t count, uint64_t limit) {
+    const auto *spans = reinterpret_cast<const Span *>(image + off);
+    return std::all_of(spans, spans + count,
+                       [limit](const Span &s) { return uint64_t{s.offset} + s.length <= limit; });
+  };
+  auto ids_below = [image](uint32_t off, uint64_t count, uint32_t limit) {
+    const auto *ids = reinterpret_cast<const uint32_t *>(image + off);
+    return std::all_of(ids, ids + count, [limit](uint32_t id) { return id < limit; });
+  };
+  valid = spans_fit(header->words_off, header->n_words, header->pool_size) &&
+          spans_fit(header->categories_off, header->n_categories, header->pool_size) &&
+          spans_fit(header->word_categories_off, header->n_words, header->n_category_ids) &&
+          spans_fit(header->postings_off, uint64_t{header->n_categories} * N_TIERS, header->n_posting_ids) &&
+          ids_below(header->category_ids_off, header->n_category_ids, header->n_categories) &&
+          ids_below(header->posting_ids_off, header->n_posting_ids, header->n_words) &&
+          ids_below(header->by_text_off, header->n_words, header->n_words);
+  for (size_t t = 0; t < N_TIERS; ++t) {
+    valid = valid && ids_below(header->tiers_off[t], header->tier_size[t], header->n_words);
+  }
+  if (valid) { m_header = header; }
+  return valid;
+}
+
+std::string_view Dictionary::word(uint32_t id) const {
+  const Span &s = at<Span>(m_header->words_off)[id];
+  return {at<char>(m_header->pool_off) + s.offset, s.length};
+}
+
+uint32_t Dictionary::find_word(std::string_view text) const {
+  if (m_header == nullptr) { return NO_WORD; }
+  const uint32_t *first = at<uint32_t>(m_header->by_text_off);
+  const uint32_t *last = first + m_header->n_words;
+  const uint32_t *it = std::lower_bound(
+      first, last, text, [this](uint32_t id, std::string_view t) { return word(id) < t; });
+  return it != last && word(*it) == text ? *it : NO_WORD;
+}
+
+Dictionary::IdList Dictionary::categories(uint32_t id) const {
+  const Span &s = at<Span>(m_header->word_categories_off)[id];
+  return {at<uint32_t>(m_header->category_ids_off) + s.offset, s.length};
+}
+
+std::string_view Dictionary::category(uint32_t category_id) const {
+  const Span &s = at<Span>(m_header->categories_off)[category_id];
+  return {at<char>(m_header->pool_off) + s.offset, s.length};
+}
+
+uint32_t Dictionary::find_category(std::string_view name) const {
+  for (uint32_t c = 0; c < n_categories(); ++c) {
+    if (category(c) == name) { return c; }
+  }
+  return NO_CATEGORY;
+}
+
+const Dictionary::Signature &Dictionary::signature(uint32_t id) const {
+  return at<Signature>(m_header->signatures_off)[id];
+}
+
+Dictionary::IdList Dictionary::tier(tier_e t) const {
+  if (m_header == nullptr) { return {}; }
+  return {at<uint32_t>(m_header->tiers_off[t]), m_header->tier_size[t]};
+}
+
+Dictionary::IdList Dictionary::words_in(uint32_t category_id, tier_e t) const {
+  if (category_id == NO_CATEGORY || m_header == nullptr) { return tier(t); }
+  const Span &s = at<Span>(m_header->postings_off)[category_id * N_TIERS + t];
+  return {at<uint32_t>(m_header->posting_ids_off) + s.offset, s.length};
+}
@@ -0,0 +1,246 @@
+#ifndef DICTIONARY_H
+#define DICTIONARY_H
+/*!
+ * Dictionary class
+ * @file dictionary.h
+ *
+ * The dictionary holds every word the game may choose from, already
+ * normalized (upper case), together with its categories, its letter
+ * signature and the difficulty tier it belongs to.
+ *
+ * Text is stored as UTF-8 in one shared pool. The corpus is mostly
+ * ASCII, so that is about a quarter of the size of wide strings, and
+ * words and category names are handed out as views into the pool.
+ * Entries may be phrases ("MESTRE DE OBRAS"): anything that is not a
+ * letter is just kept as is.
+ *
+ * Its contents live in a single flat *image* that has the exact same
+ * layout in memory and on disk. The image is either read in place
+ * from a compiled dictionary file (see the `hangman_dictc` tool) or,
+ * when that file is missing or stale, built in memory from words.csv.
+ * Either way the game reads it through views, without any parsing.
+ *
+ * Image layout (native endianness, every section 4-byte aligned):
+ * ```
+ *  Header
+ *  Span     words[n_words]             -> word text in the pool (bytes)
+ *  Span     word_categories[n_words]   -> slice of category_ids
+ *  uint32_t category_ids[n_category_ids]
+ *  Span     categories[n_categories]   -> category name in the pool (bytes)
+ *  uint32_t tiers[N_TIERS][...]        -> word ids per difficulty tier
+ *  Signature signatures[n_words]       -> 8-byte aligned
+ *  Span     postings[n_categories][N_TIERS] -> slice of posting_ids
+ *  uint32_t posting_ids[n_posting_ids]
+ *  uint32_t by_text[n_words]           -> word ids sorted by text
+ *  char     pool[pool_size]            -> UTF-8 text
+ * ```
+ *
+ * The postings form an inverted index from each category to the
+ * sorted ids of its words, already split by difficulty tier, so a word
+ * of a given category and tier is drawn without scanning anything.
+ *
+ * Tiers come from the letter signatures rather than from word length:
+ * each word is scored by the information (in bits, against the letter
+ * frequencies of the whole corpus) of the distinct letters the player
+ * has to find, and the corpus is split into thirds by that score.
+ *
+ * Word ids are the row numbers of the words file, so they stay stable
+ * (and so do the played word lists saved with them) as long as words
+ * are only ever appended to it.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "../utils/mapped_file.h"
+#include "alphabet.h"
+
+class Dictionary {
+  //=== Public types
+public:
+  /// Difficulty tiers, in the order they are stored in the image.
+  enum tier_e : uint32_t {
+    EASY = 0, //!< Few, common letters.
+    NORMAL,   //!< Average words.
+    HARD,     //!< Many distinct and rare letters.
+    N_TIERS,
+  };
+
+  /// Letter signature of a word, computed once when the image is built.
+  struct Signature {
+    alphabet::mask_t letters; //!< Set of letters in the word, accents folded.
+    float rarity;             //!< Sum of -log2(frequency) over the distinct letters.
+    uint32_t distinct;        //!< Number of distinct letters.
+  };
+
+  /// Offset/length pair pointing into another section of the image.
+  struct Span {
+    uint32_t offset; //!< First element.
+    uint32_t length; //!< Number of elements.
+  };
+
+  /// Read-only view over a run of word or category ids.
+  struct IdList {
+    const uint32_t *data = nullptr; //!< First id.
+    size_t count = 0;               //!< Number of ids.
+
+    [[nodiscard]] const uint32_t *begin() const { return data; }
+    [[nodiscard]] const uint32_t *end() const { return data + count; }
+    [[nodiscard]] size_t size() const { return count; }
+    [[nodiscard]] bool empty() const { return count == 0; }
+    uint32_t operator[](size_t i) const { return data[i]; }
+  };
+
+  /// Fixed header at the start of every image.
+  struct Header {
+    char magic[8];               //!< Always MAGIC.
+    uint32_t version;            //!< Always VERSION.
+    uint32_t image_size;         //!< Total size of the image, in bytes.
+    uint64_t source_size;        //!< Size of the words file it was built from.
+    int64_t source_mtime;        //!< Modification time of that file (ns).
+    uint32_t n_words;            //!< Number of words.
+    uint32_t n_categories;       //!< Number of distinct categories.
+    uint32_t n_category_ids;     //!< Length of the category_ids section.
+    uint32_t pool_size;          //!< Length of the text pool, in bytes.
+    uint32_t tier_size[N_TIERS]; //!< Number of word ids in each tier.
+    uint32_t words_off;          //!< Byte offset of the words section.
+    uint32_t word_categories_off;
+    uint32_t category_ids_off;
+    uint32_t categories_off;
+    uint32_t tiers_off[N_TIERS];
+    uint32_t signatures_off;
+    uint32_t n_posting_ids;      //!< Length of the posting_ids section.
+    uint32_t postings_off;
+    uint32_t posting_ids_off;
+    uint32_t by_text_off;
+    uint32_t pool_off;
+  };
+
+  static constexpr char MAGIC[8] = {'H', 'G', 'M', 'D', 'I', 'C', 'T', '\0'};
+  static constexpr uint32_t VERSION = 6;
+  /// Word id meaning "no such word".
+  static constexpr uint32_t NO_WORD = UINT32_MAX;
+  /// Category id meaning "any category".
+  static constexpr uint32_t NO_CATEGORY = UINT32_MAX;
+
+  //=== Data members
+private:
+  MappedFile m_file;                //!< Backing file, when read from disk.
+  std::vector<uint32_t> m_owned;    //!< Backing memory, when built from a csv.
+  const Header *m_header = nullptr; //!< Header of the image in use.
+
+  //=== Public interface
+public:
+  Dictionary() = default;
+  Dictionary(const Dictionary &) = delete;
+  Dictionary &operator=(const Dictionary &) = delete;
+  Dictionary(Dictionary &&) = default;
+  Dictionary &operator=(Dictionary &&) = default;
+  ~Dictionary() = default;
+
+  /**
+   * @brief Open a compiled dictionary file and use it in place.
+   *
+   * @param path The compiled dictionary.
+   * @param source_path The words file it should be up to date with. The
+   * check is skipped if it is null or cannot be read.
+   * @return true if the file is a valid, current dictionary: every span
+   * and id in it points inside the image. Otherwise build() it again.
+   */
+  bool open(const char *path, const char *source_path = nullptr);
+
+  /**
+   * @brief Build the dictionary in memory from a words file.
+   *
+   * @param csv_path The words file.
+   * @return true if the file could be read.
+   */
+  bool build(const char *csv_path);
+
+  /**
+   * @brief Compile a words file into a dictionary image.
+   *
+   * @param csv Contents of the words file.
+   * @param source_size Size of the words file, stored for staleness checks.
+   * @param source_mtime Modification time of the words file (ns).
+   * @return The image, ready to be written to disk.
+   */
+  static std::vector<uint32_t> compile(std::string_view csv, uint64_t source_size = 0,
+                                       int64_t source_mtime = 0);
+
+  /**
+   * @brief Read the size and modification time of a file.
+   *
+   * @return false if the file does not exist.
+   */
+  static bool file_stamp(const char *path, uint64_t &size, int64_t &mtime);
+
+  /// Return whether a dictionary has been loaded.
+  [[nodiscard]] bool is_loaded() const { return m_header != nullptr; }
+
+  /// Return the number of words.
+  [[nodiscard]] size_t size() const { return m_header ? m_header->n_words : 0; }
+
+  /// Return the text of a word, in UTF-8.
+  [[nodiscard]] std::string_view word(uint32_t id) const;
+
+  /**
+   * @brief Look a word up by its text, in O(log n).
+   *
+   * @param text The word, in upper case UTF-8.
+   * @return Its id, or NO_WORD if it is not in the dictionary.
+   */
+  [[nodiscard]] uint32_t find_word(std::string_view text) const;
+
+  /// Return the category ids of a word.
+  [[nodiscard]] IdList categories(uint32_t id) const;
+
+  /// Return the letter signature of a word.
+  [[nodiscard]] const Signature &signature(uint32_t id) const;
+
+  /// Return the number of distinct categories.
+  [[nodiscard]] size_t n_categories() const { return m_header ? m_header->n_categories : 0; }
+
+  /// Return the name of a category, in UTF-8.
+  [[nodiscard]] std::string_view category(uint32_t category_id) const;
+
+  /**
+   * @brief Look a category up by name.
+   *
+   * @param name The category name, in upper case UTF-8.
+   * @return Its id, or NO_CATEGORY if there is no such category.
+   */
+  [[nodiscard]] uint32_t find_category(std::string_view name) const;
+
+  /// Return the ids of the words in a difficulty tier.
+  [[nodiscard]] IdList tier(tier_e t) const;
+
+  /**
+   * @brief Return the sorted ids of the words in both a category and a tier.
+   *
+   * @param category_id The category, or NO_CATEGORY for the whole tier.
+   * @param t The difficulty tier.
+   */
+  [[nodiscard]] IdList words_in(uint32_t category_id, tier_e t) const;
+
+private:
+  /// Compute the letter signature of every word, in parallel.
+  static std::vector<Signature> compute_signatures(const std::string &pool,
+                                                   const std::vector<Span> &words);
+
+  /// Assign a difficulty tier to every word from its signature.
+  static std::vector<uint8_t> classify(const std::vector<Signature> &signatures);
+
+  /// Validate the image at `base` and start using it.
+  bool attach(const void *base, size_t size);
+
+  /// Return a pointer `offset` bytes into the image.
+  template <typename T> const T *at(uint32_t offset) const {
+    return reinterpret_cast<const T *>(reinterpret_cast<const char *>(m_header) + offset);
+  }
+};
+#endif
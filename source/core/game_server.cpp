@@ -0,0 +1,353 @@
+/*!
+ * Game server implementation.
+ *
+ * \file game_server.cpp
+ */
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <iostream>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <utility>
+
+#include "../utils/utf8.h"
+#include "game_server.h"
+
+/// Returns `path` with its extension replaced: words.csv -> words.hgd.
+static std::string with_extension(const std::string &path, const char *extension) {
+  return std::filesystem::path(path).replace_extension(extension).string();
+}
+
+GameServer::GameServer(ServerOptions options)
+    : m_options{std::move(options)},
+      m_store{m_options.players_path, with_extension(m_options.players_path, ".idx")},
+      m_journal{m_options.players_path, with_extension(m_options.players_path, ".journal"),
+                with_extension(m_options.players_path, ".idx")} {}
+
+GameServer::~GameServer() {
+  for (auto &connection : m_connections) {
+    if (connection) { close(connection->fd); }
+  }
+  if (m_listener >= 0) {
+    ::close(m_listener);
+    if (!m_options.unix_path.empty()) { ::unlink(m_options.unix_path.c_str()); }
+  }
+  if (m_epoll >= 0) { ::close(m_epoll); }
+}
+
+bool GameServer::start() {
+  if (!m_words.load(m_options.words_path)) {
+    std::wcerr << L"Unable to open the words file." << std::endl;
+    return false;
+  }
+  m_words.watch([](const Dictionary *words) {
+    if (words == nullptr) {
+      std::wcerr << L"Words file not reloaded: unreadable, or changed other than by appending words;"
+                 << L" playing on with the words loaded." << std::endl;
+    } else {
+      std::wcerr << L"Words reloaded: " << words->size() << L" words." << std::endl;
+    }
+  });
+  if (!m_store.exists() && m_store.open()) {
+    m_store.import_text(with_extension(m_options.players_path, ".txt").c_str(), *m_words.current());
+  }
+  if (!m_store.open()) {
+    std::wcerr << L"Unable to open the players file." << std::endl;
+    return false;
+  }
+  // Only the leaderboard keeps every player; the players journaled since
+  // the snapshot are ranked again over it, and not kept.
+  m_store.for_each([this](const Player &player) { m_leaderboard.update(player); });
+  std::unordered_map<std::wstring, Player> players;
+  m_journal.replay(players);
+  for (const auto &[name, player] : players) { m_leaderboard.update(player); }
+  return listen();
+}
+
+bool GameServer::listen() {
+  m_epoll = ::epoll_create1(EPOLL_CLOEXEC);
+  if (m_epoll < 0) {
+    std::wcerr << L"Unable to create the event loop: " << std::strerror(errno) << std::endl;
+    return false;
+  }
+  sockaddr_storage address{};
+  socklen_t size;
+  if (!m_options.unix_path.empty()) {
+    auto &un = reinterpret_cast<sockaddr_un &>(address);
+    if (m_options.unix_path.size() >= sizeof(un.sun_path)) {
+      std::wcerr << L"The socket path is too long." << std::endl;
+      return false;
+    }
+    un.sun_family = AF_UNIX;
+    std::memcpy(un.sun_path, m_options.unix_path.c_str(), m_options.unix_path.size() + 1);
+    size = sizeof(sockaddr_un);
+    // A socket file left by an earlier run would make bind() fail.
+    ::unlink(m_options.unix_path.c_str());
+  } else {
+    auto &in = reinterpret_cast<sockaddr_in &>(address);
+    in.sin_family = AF_INET;
+    in.sin_port = htons(m_options.port);
+    in.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    size = sizeof(sockaddr_in);
+  }
+  m_listener = ::socket(address.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  int yes = 1;
+  if (m_listener >= 0 && address.ss_family == AF_INET) {
+    ::setsockopt(m_listener, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+  }
+  if (m_listener < 0 || ::bind(m_listener, reinterpret_cast<sockaddr *>(&address), size) != 0 ||
+      ::listen(m_listener, SOMAXCONN) != 0) {
+    std::wcerr << L"Unable to listen: " << std::strerror(errno) << std::endl;
+    return false;
+  }
+  epoll_event event{};
+  event.events = EPOLLIN;
+  event.data.fd = m_listener;
+  return ::epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_listener, &event) == 0;
+}
+
+void GameServer::run(const volatile bool &stop) {
+  epoll_event events[64];
+  while (!stop) {
+    int n = ::epoll_wait(m_epoll, events, 64, -1);
+    for (int i = 0; i < n; ++i) {
+      int fd = events[i].data.fd;
+      if (fd == m_listener) {
+        accept_all();
+        continue;
+      }
+      // A connection closed earlier in this batch may have its socket reused.
+      if (static_cast<size_t>(fd) >= m_connections.size() || !m_connections[fd]) { continue; }
+      Connection &connection = *m_connections[fd];
+      bool open = (events[i].events & (EPOLLERR | EPOLLHUP)) == 0 || (events[i].events & EPOLLIN) != 0;
+      if (open && (events[i].events & EPOLLIN) != 0) { open = receive(connection); }
+      if (open) { open = flush(connection); }
+      if (!open) { close(fd); }
+    }
+  }
+}
+
+void GameServer::accept_all() {
+  while (true) {
+    int fd = ::accept4(m_listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0) { return; } // EAGAIN once every pending one is in, or out of descriptors.
+    if (m_options.unix_path.empty()) {
+      // Answers are single small writes; do not hold them back.
+      int yes = 1;
+      ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+    }
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    if (::epoll_ctl(m_epoll, EPOLL_CTL_ADD, fd, &event) != 0) {
+      ::close(fd);
+      continue;
+    }
+    if (static_cast<size_t>(fd) >= m_connections.size()) { m_connections.resize(fd + 1); }
+    m_connections[fd] = std::make_unique<Connection>();
+    m_connections[fd]->fd = fd;
+  }
+}
+
+bool GameServer::receive(Connection &connection) {
+  char buffer[16 * 1024];
+  ssize_t n = ::recv(connection.fd, buffer, sizeof(buffer), 0);
+  if (n == 0) { return false; }
+  if (n < 0) { return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR; }
+  connection.in.append(buffer, static_cast<size_t>(n));
+  size_t begin = 0;
+  for (size_t end; (end = connection.in.find('\n', begin)) != std::string::npos; begin = end + 1) {
+    std::string_view line(connection.in.data() + begin, end - begin);
+    if (!line.empty() && line.back() == '\r') { line.remove_suffix(1); }
+    handle_line(connection, line);
+  }
+  connection.in.erase(0, begin);
+  // A line too long, or a client that sends faster than it reads.
+  return connection.in.size() <= MAX_LINE && connection.out.size() - connection.sent <= MAX_PENDING;
+}
+
+void GameServer::handle_line(Connection &connection, std::string_view line) {
+  utf8::decode(m_text, line);
+  if (!connection.session) {
+    if (m_text.empty()) {
+      answer(connection, false);
+      return;
+    }
+    login(connection);
+    return;
+  }
+  Session &session = *connection.session;
+  Session::Input input;
+  if (session.expects() == Session::input_e::LINE) {
+    input.line = m_text;
+  } else {
+    input.key = m_text.empty() ? L'\n' : m_text.front();
+  }
+  bool valid = session.handle(input);
+  save_changes(connection);
+  if (session.screen() == Session::screen_e::ENDED) { logout(connection); }
+  answer(connection, valid);
+}
+
+void GameServer::login(Connection &connection) {
+  if (m_online.count(m_text) != 0) {
+    connection.out += "BUSY\n";
+    return;
+  }
+  // The store is read here: let any fold into it finish first.
+  m_journal.wait();
+  m_store.open();
+  Player player(m_text);
+  bool known = m_store.load(m_text, player);
+  known = m_journal.replay(player) || known;
+  connection.session.emplace(m_words, m_leaderboard, std::move(player), m_rng());
+  m_online.insert(m_text);
+  ++m_n_sessions;
+  if (!known) { journal(connection.session->player(), PlayerJournal::event_e::JOINED); }
+  answer(connection, true);
+}
+
+void GameServer::logout(Connection &connection) {
+  if (!connection.session) { return; }
+  // A player who drops out of a match loses it, as if leaving it.
+  connection.session->forfeit();
+  save_changes(connection);
+  // Everything the player did is journaled; the next login reads it back.
+  m_online.erase(connection.session->player().name());
+  connection.session.reset();
+}
+
+void GameServer::answer(Connection &connection, bool valid) {
+  std::string &out = connection.out;
+  if (!valid) { out += "ERROR "; }
+  if (!connection.session) {
+    out += "BYE\n";
+    return;
+  }
+  const Session &session = *connection.session;
+  Session::View view = session.view();
+  switch (view.screen) {
+  case Session::screen_e::MAIN_MENU:
+    out += "MENU";
+    break;
+  case Session::screen_e::RULES:
+    out += "RULES";
+    break;
+  case Session::screen_e::SCOREBOARD:
+    out += "SCOREBOARD ";
+    out += std::to_string(static_cast<short>(view.board_order) + 1);
+    out += ' ';
+    out += std::to_string(view.board_first + 1);
+    out += ' ';
+    out += std::to_string(m_leaderboard.size());
+    out += ' ';
+    out += std::to_string(m_leaderboard.rank(view.board_order, view.player->name()));
+    break;
+  case Session::screen_e::QUITTING:
+    out += "QUITTING";
+    break;
+  case Session::screen_e::DIFICULT:
+    out += "DIFICULT";
+    break;
+  case Session::screen_e::CATEGORY:
+    out += "CATEGORY";
+    break;
+  case Session::screen_e::NO_WORDS:
+    out += "NO_WORDS";
+    break;
+  case Session::screen_e::ENDED:
+    out += "BYE";
+    break;
+  case Session::screen_e::PLAYING: {
+    const Match &match = *view.match;
+    const HangmanWord &word = match.word();
+    if (match.status() != Match::status_e::ON) {
+      out += match.status() == Match::status_e::WON ? "WON " : "LOST ";
+      out += std::to_string(view.player->score());
+      out += ' ';
+      utf8::encode(out, word.secret_word());
+    } else if (session.expects() == Session::input_e::LINE) {
+      out += "WORD";
+    } else {
+      static const char *const notices[] = {"-", "DIGIT", "REPEATED"};
+      out += "PLAYING ";
+      out += std::to_string(word.wrong_guesses());
+      out += ' ';
+      out += std::to_string(view.player->score());
+      out += ' ';
+      out += notices[static_cast<short>(view.notice)];
+      out += ' ';
+      utf8::encode(out, word.masked_str());
+    }
+    break;
+  }
+  }
+  out += '\n';
+}
+
+void GameServer::journal(const Player &player, PlayerJournal::event_e event, uint32_t word) {
+  m_leaderboard.update(player);
+  if (!m_journal.append(player, event, word)) {
+    std::wcerr << L"Unable to write the players journal." << std::endl;
+  }
+  if (m_journal.size() > PlayerJournal::COMPACT_THRESHOLD) { m_journal.compact(); }
+}
+
+void GameServer::save_changes(Connection &connection) {
+  const Player &player = connection.session->player();
+  connection.session->flush_changes([&](const Session::Change &change) {
+    switch (change.event) {
+    case Session::Change::event_e::MATCH_STARTED:
+      journal(player, PlayerJournal::event_e::MATCH_STARTED, change.word);
+      break;
+    case Session::Change::event_e::MATCH_ENDED:
+      journal(player, PlayerJournal::event_e::MATCH_ENDED);
+      break;
+    case Session::Change::event_e::WORDS_CLEARED:
+      journal(player, PlayerJournal::event_e::WORDS_CLEARED);
+      break;
+    }
+  });
+}
+
+bool GameServer::flush(Connection &connection) {
+  while (connection.sent < connection.out.size()) {
+    ssize_t n = ::send(connection.fd, connection.out.data() + connection.sent, connection.out.size() - connection.sent,
+                       MSG_NOSIGNAL);
+    if (n < 0) {
+      if (errno == EINTR) { continue; }
+      if (errno != EAGAIN && errno != EWOULDBLOCK) { return false; }
+      break;
+    }
+    connection.sent += static_cast<size_t>(n);
+  }
+  bool pending = connection.sent < connection.out.size();
+  if (!pending) {
+    connection.out.clear();
+    connection.sent = 0;
+  }
+  // Watch for room to write only while something is waiting to be sent.
+  if (pending != connection.writing) {
+    epoll_event event{};
+    event.events = static_cast<uint32_t>(pending ? EPOLLIN | EPOLLOUT : EPOLLIN);
+    event.data.fd = connection.fd;
+    ::epoll_ctl(m_epoll, EPOLL_CTL_MOD, connection.fd, &event);
+    connection.writing = pending;
+  }
+  return true;
+}
+
+void GameServer::close(int fd) {
+  logout(*m_connections[fd]);
+  ::close(fd);
+  m_connections[fd].reset();
+}
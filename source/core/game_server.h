@@ -0,0 +1,160 @@
+#ifndef GAME_SERVER_H
+#define GAME_SERVER_H
+/*!
+ * Game server class
+ * @file game_server.h
+ *
+ * Hosts many players at once, each on a connection to a Unix domain or
+ * localhost TCP socket, in one thread: an epoll loop reads what each
+ * connection sent, feeds every complete line to that connection's
+ * Session (see session.h) and sends back the answer, never blocking on
+ * any one client. All sessions share one dictionary, one player store
+ * with its journal, and one leaderboard.
+ *
+ * The words are reloaded, without a restart, when the words file
+ * changes or reload_words() is called; matches in progress finish with
+ * the words they started with (see shared_dictionary.h).
+ *
+ * As in the terminal game, only the leaderboard holds every player: a
+ * player is read from the store and the journal when logging in, every
+ * change is journaled as it happens, and the player is dropped on
+ * logging out. A player can be logged in on one connection at a time.
+ *
+ * Protocol: lines of UTF-8 text, '\n' ended ('\r' is ignored). The
+ * first line a connection sends is the player's name; then every line
+ * is one input: its first character when the screen reads a key (an
+ * empty line is Enter), or the whole line when it reads a line. After
+ * the name and after every input the server answers one line, naming
+ * the screen the player is now on:
+ * ```
+ *  MENU | RULES | QUITTING | DIFICULT | CATEGORY | NO_WORDS
+ *  SCOREBOARD <order 1-4> <first position> <players> <player's rank>
+ *  PLAYING <wrong guesses> <score> <-|DIGIT|REPEATED> <masked word>
+ *  WORD                       (the next line is the whole word)
+ *  WON <score> <word> | LOST <score> <word>
+ *  BYE                        (logged out, or an empty name; the next line is a name)
+ *  BUSY                       (the name is logged in elsewhere)
+ * ```
+ * An answer to an input that is not valid on the screen starts with
+ * "ERROR ". A line longer than MAX_LINE bytes closes the connection.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "dictionary.h"
+#include "leaderboard.h"
+#include "player.h"
+#include "player_journal.h"
+#include "player_store.h"
+#include "session.h"
+#include "shared_dictionary.h"
+
+/// Where the server keeps its files, and where it listens.
+struct ServerOptions {
+  std::string words_path = "words.csv";     //!< Words file; the compiled dictionary is kept next to it, as .hgd.
+  std::string players_path = "Players.dat"; //!< Player store; its index and journal are kept next to it.
+  std::string unix_path;                    //!< Unix domain socket to listen on, if not empty.
+  uint16_t port = 0;                        //!< Otherwise, localhost TCP port to listen on.
+};
+
+class GameServer {
+  //=== Private types
+private:
+  /// One client.
+  struct Connection {
+    int fd = -1;                    //!< The socket.
+    std::string in;                 //!< Bytes received, not handled yet.
+    std::string out;                //!< Bytes to send.
+    size_t sent = 0;                //!< Bytes of `out` already sent.
+    bool writing = false;           //!< Whether the socket is watched for writing.
+    std::optional<Session> session; //!< The player's session, once logged in.
+  };
+
+  //=== Data members
+  ServerOptions m_options;                                 //!< Files and socket.
+  PlayerStore m_store;                                     //!< Players saved by earlier runs.
+  PlayerJournal m_journal;                                 //!< Records player changes as they happen.
+  SharedDictionary m_words;                                //!< All words, shared by every session.
+  Leaderboard m_leaderboard;                               //!< Every player, ranked.
+  std::unordered_set<std::wstring> m_online;               //!< Names logged in.
+  std::vector<std::unique_ptr<Connection>> m_connections;  //!< Connections, by socket.
+  std::wstring m_text;                                     //!< The latest line, decoded.
+  std::mt19937_64 m_rng{std::random_device{}()};           //!< Seeds the sessions.
+  int m_listener = -1;                                     //!< The listening socket.
+  int m_epoll = -1;                                        //!< The epoll instance.
+  size_t m_n_sessions = 0;                                 //!< Sessions started.
+
+public:
+  /// Longest line a client may send, in bytes.
+  static constexpr size_t MAX_LINE = 1024;
+  /// Most bytes a connection may leave unread before it is closed.
+  static constexpr size_t MAX_PENDING = 64 * MAX_LINE;
+
+  explicit GameServer(ServerOptions options);
+  GameServer(const GameServer &) = delete;
+  GameServer &operator=(const GameServer &) = delete;
+  /// Closes every connection, logging their players out.
+  ~GameServer();
+
+  /**
+   * @brief Load the words and the players, and start listening.
+   *
+   * @return false, after saying why on std::cerr, if any of it failed.
+   */
+  bool start();
+
+  /**
+   * @brief Serve clients until `stop` becomes true (checked whenever a
+   * signal interrupts the wait).
+   */
+  void run(const volatile bool &stop);
+
+  /// Reload the words in the background; async-signal-safe.
+  void reload_words() const { m_words.request_reload(); }
+
+  /// Return the number of sessions started so far.
+  [[nodiscard]] size_t n_sessions() const { return m_n_sessions; }
+
+private:
+  /// Accept every pending connection.
+  void accept_all();
+
+  /// Read what a connection sent and handle its complete lines; false if it is to be closed.
+  bool receive(Connection &connection);
+
+  /// Handle one line from a connection.
+  void handle_line(Connection &connection, std::string_view line);
+
+  /// Log a player in on a connection, or answer BUSY.
+  void login(Connection &connection);
+
+  /// Forfeit the player's match on, if any, and drop the player.
+  void logout(Connection &connection);
+
+  /// Append the answer for the connection's screen to its output.
+  void answer(Connection &connection, bool valid);
+
+  /// Journal a change to a player, rank the player again, and compact the journal once it grows too large.
+  void journal(const Player &player, PlayerJournal::event_e event, uint32_t word = Dictionary::NO_WORD);
+
+  /// Journal the changes the connection's session made.
+  void save_changes(Connection &connection);
+
+  /// Send what the connection has to send; false if it is to be closed.
+  bool flush(Connection &connection);
+
+  /// Close a connection, logging its player out.
+  void close(int fd);
+
+  /// Listen on the socket of the options.
+  bool listen();
+};
+
+#endif
@@ -1,20 +1,35 @@
 #ifndef _HANGMAN_GM_H_
 #define _HANGMAN_GM_H_
 
-#include <array>
 #include <string> // std::string
-#include <unordered_map>
 #include <iostream>
-#include <vector>
-#include <algorithm>
-#include <limits>
-
-#include "hm_word.h"
-#include "player.h"
+#include <optional>
+#include <random>
+
+#include "../utils/frame.h"
+#include "../utils/terminal.h"
+#include "dictionary.h"
+#include "leaderboard.h"
+#include "player_journal.h"
+#include "player_store.h"
+#include "session.h"
+#include "shared_dictionary.h"
+
+/// Where the game keeps its files, and how it runs.
+struct GameOptions {
+  std::string words_path = "words.csv";     //!< Words file; the compiled dictionary is kept next to it, as .hgd.
+  std::string players_path = "Players.dat"; //!< Player store; its index (.idx), journal (.journal) and the
+                                            //!< old text file (.txt) are kept next to it.
+  bool headless = false;                    //!< Draw nothing and print a result line per match; a quit
+                                            //!< starts the next session, until the input ends.
+  int input_fd = STDIN_FILENO;              //!< Where commands are read from.
+};
 
 /*!
- * This class represents the Game Controller which keeps track of player,
- * scores, and match total values, as well as determining when a match ends.
+ * This class represents the Game Controller: the terminal front end of
+ * the game. It loads the words and players, reads the keyboard, draws
+ * the screens and saves the players; the game itself is played by a
+ * Session (see session.h), one per player logged in.
  */
 class GameController {
 private:
@@ -22,83 +37,36 @@ private:
   //!< The game states.
   enum class game_state_e : short {
     STARTING = 0, //!< Beginning the game.
-    WELCOME,      //!< Opening messasges.
-    MAIN_MENU,    //!< Enter main menu mode, reading option from the player.
-    PLAYING,      //!< Playing the game.
-    SHOW_SCORE,   //!< Show top scores.
-    SHOW_RULES,   //!< Asks user if s/he wants to read the rules.
-    QUITTING,     //!< User might want to quit (before game finishes), need to
-                  //!< confirm.
-    DIFICULT,     //!< Enter dificult selection mode.
+    WELCOME,      //!< Opening messasges, reading the player's name.
+    SESSION,      //!< A player is logged in; the Session tells what is on screen.
     ENDING,       //!< Closing the game (final message).
-    NO_WORDS,     //!< Show the mensage that has no words to play.
-  };
-
-  //!< The menu options.
-  enum class menu_e : short {
-    PLAY = 1,  //!< Begin new game.
-    RULES,     //!< Show rules of the game.
-    SCORE,     //!< Show top scores.
-    EXIT,      //!< Exit the game.
-    DIFICULT,  //!< Difucult selection.
-    UNDEFINED, //!< No option chosen.
-  };
-
-  //!< The match status.
-  enum class match_e : short {
-    ON = 1,      //!< Match still open and running.
-    PLAYER_WON,  //!< Match ended and player WON.
-    PLAYER_LOST, //!< Match ended and player LOST.
-    UNDEFINED,   //!< Undefined match status.
-  };
-
-  //!< The dificult options
-  enum class dificult_e : short {
-    NORMAL = 0,   //!< Medium dificult with none letters reveal.
-    EASY,     //!< Easiest dificult with some letters reveal.
-    HARD,       //!< Hardest dificult with complex words.
-  };
-
-  //!< Struct with a word and its categories.
-  struct Word {
-    std :: wstring word;
-    std :: vector<std :: wstring> categories;
   };
 
   //=== Data members
-  game_state_e m_game_state; //!< Current game state.
-  menu_e m_menu_option;      //!< Current menu option.
-  dificult_e m_dificult = dificult_e::NORMAL;     //!< Current dificult.
-  std::wstring m_system_msg; //!< Current system message displayed to user.
-  bool m_asked_to_quit;      //!< Flag that indicates whether the user wants to end
-                             //!< an ongoing game.
-  bool m_match_ended;        //!< Flag that indicates whether the current match has
-                             //!< ended or not.
-  bool m_reveal_word;        //!< Flag that is active when user looses and we need to
-                             //!< show the answer.
-  bool m_asked_to_leave;     //!< Flag that is active when user wants to leave the match.
-  bool m_repeated;           //!< Flag that is active when user insert a repeated word.
-  bool m_digit;              //!< Flag that is active when user insert a digit.
-  bool m_guess_all;          //!< Flag that is active when user wants to guess the entire word.
+  GameOptions m_options; //!< Files and mode the game runs with.
+  size_t m_n_sessions = 0; //!< Sessions started; only headless runs have more than one.
+  game_state_e m_game_state = game_state_e::STARTING; //!< Current game state.
+  bool m_asked_to_quit = false; //!< Flag that indicates whether the user wants to end the game.
+  bool m_input_ended = false; //!< Flag that is active once the input is closed.
   
   //=== Game related members
-  std::unordered_map<std::wstring, Player> m_players;         //!< List of players, indexed by name (must be unique).
-  Player *m_curr_player;                                      //!< Reference to the current player.
-  wchar_t m_ch_guess = 0;                                     //!< Latest player guessed letter.
-  HangmanWord m_secret_word;                                  //!< Keeps track of the masked word, wrong guesses, etc.
-  size_t m_max_mistakes = 6;                                  //!< Max number of mistakes allowed in a match.
-  std::wstring m_user_name;                                   //!< Stores the user name provided in the Welcome state.
-  size_t m_curr_word_idx;                                     //!< Index of the current secret word.
-  match_e m_match;                                            //!< Current match state.
-  std :: vector<Word> m_all_words;                            //!< List of all words and its categories.
-  std :: vector<Word> m_easy_words;                           //!< List of easy words and its categories.
-  std :: vector<Word> m_normal_words;                         //!< List of normal words and its categories.
-  std :: vector<Word> m_hard_words;                           //!< List of hard words and its categories.
-  std :: vector<std :: wstring> m_current_categories;         //!< List of current categories.
+  PlayerStore m_store;                                        //!< Players saved in earlier sessions, read on demand.
+  Leaderboard m_leaderboard;                                  //!< Players ranked in several orders, filled on first use.
+  SharedDictionary m_words;                                   //!< All words, their categories and dificult tiers.
+  std :: optional<Session> m_session;                         //!< The logged in player's session.
+  std::wstring m_line;                                        //!< Buffer for the latest line typed.
+  std :: mt19937 m_rng{std :: random_device{}()};             //!< Seeds the sessions.
+  PlayerJournal m_journal;                                    //!< Records player changes as they happen.
+  mutable Frame m_frame;                                      //!< The screen being drawn by render().
+  Terminal m_terminal;                                        //!< Keyboard input, one key at a time on a terminal.
 
 public:
   //=== Public interface
-  GameController() = default;
+  /// Columns of the lines printed by a headless game, one per match.
+  static constexpr const wchar_t *RESULTS_HEADER =
+      L"session,player,dificult,word,result,wrong_guesses,correct_guesses,score";
+
+  explicit GameController(GameOptions options = {});
   GameController(const GameController &) = delete;
   GameController(GameController &&) = delete;
   GameController &operator=(const GameController &) = delete;
@@ -112,6 +80,12 @@ public:
    */
   void render() const;
 
+  /**
+   * @brief Make the next render() draw the whole screen, instead of the
+   * lines that changed.
+   */
+  void redraw() const { m_frame.invalidate(); }
+
   /**
    * @brief Update the game based on the current game state.
    */
@@ -130,48 +104,30 @@ public:
 
 private:
   // === These read_xxx() methods are called in process_events()
-  /// Reads the user command inside the action screen.
-  
-  /**
-   * @brief Read the user's name from the input.
-   * @return The user's name as a wide string.
+  /* Keys are read as they are pressed, with no 'Enter' needed, except for
+   * names, words and numbers, which are read as lines. Once the input is
+   * closed they return at once, with m_input_ended set.
    */
-  std::wstring read_user_name();
-  
-  /**
-   * @brief Read the user's confirmation (yes or no).
-   * @return true if the user confirms, false otherwise.
-   */
-  bool read_user_confirmation() const;
 
   /**
-   * @brief Read the user's input and wait for an enter key press.
+   * @brief Read the next command key.
+   * @return The key; '\n' for Enter, or 0 once the input is closed.
    */
-  void read_enter_to_proceed() const;
-  
-  /**
-   * @brief Read the user's guess (single character).
-   * @return The guessed character.
-   */
-  wchar_t read_user_guess();
+  wchar_t read_command();
 
   /**
-   * @brief Read the user's full word guess.
-   * @return The guessed word as a wide string.
+   * @brief Read a line into m_line.
+   * @return false if the input was closed first.
    */
-  std :: wstring read_user_word_guess();
-  
-  /**
-   * @brief Read the user's menu option choice.
-   * @return The chosen menu option as an enumerated type.
-   */
-  menu_e read_menu_option();
+  bool read_line();
+
+  /// Tell the user the input was not valid, unless headless.
+  void reject_input(const wchar_t *message = L"Error: Invalid option, try again.") const;
 
   /**
-   * @brief Read the user's difficulty choice.
-   * @return The chosen difficulty level as an enumerated type.
+   * @brief Read the player's name, and log the player in.
    */
-  dificult_e read_dificult_option();
+  void login();
 
   // === These display_xxx() methods are called in render()
   
@@ -188,7 +144,7 @@ private:
   /**
    * @brief Display the game screen during gameplay.
    */
-  void display_play_screen() const;
+  void display_play_screen(const Session :: View& view) const;
  
   /**
    * @brief Display the exit confirmation screen.
@@ -198,7 +154,7 @@ private:
   /**
    * @brief Display the game rules.
    */
-  void display_rules() const;
+  void display_rules(const Session :: View& view) const;
  
   /**
    * @brief Display the endgame screen.
@@ -208,15 +164,17 @@ private:
   /**
    * @brief Display the scoreboard.
    */
-  void display_scoreboard() const;
+  void display_scoreboard(const Session :: View& view) const;
 
   /**
    * @brief Display the difficulty selection menu.
    */
   void display_dificult() const;
 
-  /// Show hangman.
-  void display_hangman() const;
+  /**
+   * @brief Display the category selection menu.
+   */
+  void display_categories() const;
 
   /**
    * @brief Display the scoreboard.
@@ -224,51 +182,52 @@ private:
   void display_no_words() const; 
 
   /**
-   * @brief Sort the players by score.
-   * 
-   * @return A vector of pairs containing player names and Player objects sorted by score.
+   * @brief Show the gallows with the hangman, whose body displayed depends on the
+   * number of wrong guesses.
    */
-  std :: vector<std :: pair<std :: wstring, Player>> sort_players() const;
+  void display_gallows(const HangmanWord& word) const;
 
-  // === These show_xxx() methods display common elements to every screen.
-  /* All screens may have up to 4 components:
-   *  (1) title,                  -> must have
-   *  (2) main content,           -> optional
-   *  (3) a system message,       -> optional
-   *  (4) an interaction message. -> optional
+  /**
+   * @brief Fill the leaderboard with every player in the store and the journal.
    */
-  
-  /// Evaluates the match situation, whether it's over or if it still on.
-  match_e match_status() const;
-  
+  void load_leaderboard();
+
   /**
-   * @brief Show the gallows with the hangman, whose body displayed depends on the
-   * number of mistakes made (argument).
-   * 
-   * @param mistakes The number of mistakes made, determining the hangman's display.
+   * @brief Save a change to the player: record it in the journal, and on
+   * the leaderboard once it is loaded.
+   *
+   * Compacts the journal in the background once it grows too large.
+   *
+   * @param event What changed.
+   * @param word The word drawn, when a match starts.
    */
-  void display_gallows() const;
-  
+  void journal(PlayerJournal :: event_e event, uint32_t word = Dictionary :: NO_WORD);
+
+  /// Save the changes the session made, and print the results of the matches it ended, when headless.
+  void save_changes();
+
   /**
-   * @brief Reset the match to its initial state.
+   * @brief Load the dictionary, from the compiled words file if it is
+   * up to date or from the words csv otherwise.
    */
-  void reset_match();
-  
+  void read_words_file();
+
   /**
-   * @brief Choose a word for the current match.
-   * @return The chosen word as a wide string.
+   * @brief Open the player store, importing the players of the old
+   * Players.txt file the first time.
    */
-  std::wstring choose_word();
+  void read_players_file();
 
   /**
-   * @brief Read words from the words file.
+   * @brief Print the result of the match that just ended, as a CSV line
+   * (see RESULTS_HEADER).
    */
-  void read_words_file();
+  void print_result() const;
 
   /**
-   * @brief Separate words into different categories or groups.
+   * @brief Log the player out; the next one logs in at the welcome screen.
    */
-  void separate_words();
+  void next_session();
 
 };
 #endif
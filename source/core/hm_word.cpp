@@ -15,8 +15,14 @@
 #include <random>
 #include <numeric>
 
+#include "../utils/utf8.h"
 #include "hm_word.h"
 
+namespace {
+/// Folded letter index of a wide character, or NOT_A_LETTER.
+int letter_index(wchar_t c) { return alphabet::folded_index_of(static_cast<char32_t>(c)); }
+} // namespace
+
 /**
  * @brief Construct a new HangmanWord object.
  * 
@@ -26,34 +32,56 @@
  */
 HangmanWord::HangmanWord(std::wstring secret, std::wstring show, wchar_t mask)
     : m_secret_word(std::move(secret)),
-      m_masked_word(m_secret_word),
       m_open_letters(std::move(show)),
       m_n_correct_guesses(0),
       m_n_wrong_guesses(0),
       m_mask_char(mask) {
-    for (auto &ch : m_masked_word) {
-        if (m_open_letters.find(ch) == std::wstring::npos) {
-            ch = m_mask_char;
-        }
-    }
-    m_wrong_guesses = {};
-    m_correct_guesses = {};
+    reset();
 }
 
-/// Return the number of masked lettes in the secret word.
-[[nodiscard]] size_t HangmanWord :: n_masked_ch() const{
-    short j = 0;
-    for (wchar_t c : m_masked_word){
-        if (c == L'_'){j++;}
-    }
-    return j;
+/// Initialize the object providing a (new) word, show letters and mask char.
+void HangmanWord :: initialize(std::wstring_view sw, std::wstring_view ol, wchar_t mch){
+    m_secret_word.assign(sw);
+    m_open_letters.assign(ol);
+    m_mask_char = mch;
+    reset();
 }
 
+/// Initialize the object from a word in UTF-8.
+void HangmanWord :: initialize(std::string_view sw, std::wstring_view ol, wchar_t mch){
+    utf8::decode(m_secret_word, sw);
+    m_open_letters.assign(ol);
+    m_mask_char = mch;
+    reset();
+}
+
+/// Return the mask character.
+[[nodiscard]] wchar_t HangmanWord :: mask_char() const{return m_mask_char;}
+
 /// Reset the object to its original state and mask the secret word.
 void HangmanWord::reset() {
-    m_masked_word = m_secret_word;
-    for (auto &ch : m_masked_word) {
-        if (m_open_letters.find(ch) == std::wstring::npos) {ch = m_mask_char;}
+    m_secret_letters = 0;
+    m_guessed = 0;
+    m_first_pos.fill(-1);
+    m_next_pos.assign(m_secret_word.size(), -1);
+    // Each letter is shown followed by a space: position i lives at 2 * i.
+    m_masked_word.assign(m_secret_word.size() * 2, L' ');
+    m_n_masked = 0;
+    // Link positions back to front, so each chain comes out in order.
+    for (size_t i = m_secret_word.size(); i-- > 0;) {
+        wchar_t c = m_secret_word[i];
+        int idx = letter_index(c);
+        if (idx == alphabet::NOT_A_LETTER || m_open_letters.find(c) != std::wstring::npos) {
+            m_masked_word[2 * i] = c;
+            if (idx == alphabet::NOT_A_LETTER) {continue;}
+        }
+        else {
+            m_masked_word[2 * i] = m_mask_char;
+            m_n_masked++;
+        }
+        m_secret_letters |= alphabet::bit(idx);
+        m_next_pos[i] = m_first_pos[idx];
+        m_first_pos[idx] = static_cast<int32_t>(i);
     }
     m_wrong_guesses.clear();
     m_n_correct_guesses = 0;
@@ -62,53 +90,54 @@ void HangmanWord::reset() {
 }
   
 HangmanWord :: guess_e HangmanWord :: guess(wchar_t g){
-    for (size_t i = 0; i < m_wrong_guesses.size(); i++){
-        if (m_wrong_guesses[i] == g){return guess_e :: REPEATED;}
-    }
-    for (size_t i = 0; i < m_correct_guesses.size(); i++){
-        if (m_correct_guesses[i] == g){return guess_e :: REPEATED;}
-    }
-    for (wchar_t c : m_secret_word){
-        if (c == g){
-            return guess_e :: CORRECT;
+    int idx = letter_index(g);
+    if (idx == alphabet::NOT_A_LETTER){
+        // Not part of the alphabet, so it can't be in the word; only
+        // tell whether it was tried before.
+        for (wchar_t c : m_wrong_guesses){
+            if (c == g){return guess_e :: REPEATED;}
         }
+        return guess_e :: WRONG;
     }
-    return guess_e :: WRONG;
+    if (m_guessed & alphabet::bit(idx)){return guess_e :: REPEATED;}
+    return (m_secret_letters & alphabet::bit(idx)) ? guess_e :: CORRECT : guess_e :: WRONG;
 }
 
 /// Add a guess to wrong guess list.
 void HangmanWord :: add_wrong_guess(wchar_t guess){
     m_wrong_guesses.push_back(guess);
+    int idx = letter_index(guess);
+    if (idx != alphabet::NOT_A_LETTER){m_guessed |= alphabet::bit(idx);}
     add_n_wrong_guess();
 }
 
 /// Add a guess to correct guess list.
 void HangmanWord :: add_correct_guess(wchar_t guess){
     m_correct_guesses.push_back(guess);
+    int idx = letter_index(guess);
+    if (idx != alphabet::NOT_A_LETTER){m_guessed |= alphabet::bit(idx);}
     add_n_correct_guess();
 }
 
-/// Return a the secret word with the unguessed letters masked.
-void HangmanWord :: make_masked_word(){
-    std :: wstring masked_word = L""; 
-    for (wchar_t c : m_secret_word){
-        if (c != L'\0'){masked_word = masked_word + L"_" + L" ";}
-        else {masked_word = masked_word + L" ";}
-    }
-    m_masked_word = masked_word;
-}
-
-/// Reveal a masked char.
+/// Reveal a masked char, and every accented form of it.
 void HangmanWord :: unmasked_char(wchar_t g){
-    for (size_t i = 0; i < m_secret_word.size(); i++){
-        if (m_secret_word[i] == g){m_masked_word[i * 2] = g;}
+    int idx = letter_index(g);
+    if (idx == alphabet::NOT_A_LETTER){return;}
+    for (int32_t i = m_first_pos[idx]; i >= 0; i = m_next_pos[i]){
+        if (m_masked_word[i * 2] == m_mask_char){
+            m_masked_word[i * 2] = m_secret_word[i];
+            m_n_masked--;
+        }
     }
 }
 
-/// Check if all chars are revealed.
-bool HangmanWord :: all_unmasked(){
-    for(wchar_t c : m_masked_word){
-        if (c == L'_'){return false;}
+/// Check a guess of the whole word, ignoring accents.
+bool HangmanWord :: matches(std::wstring_view word) const{
+    if (word.size() != m_secret_word.size()){return false;}
+    for (size_t i = 0; i < word.size(); ++i){
+        int a = letter_index(word[i]);
+        int b = letter_index(m_secret_word[i]);
+        if (a != b || (a == alphabet::NOT_A_LETTER && word[i] != m_secret_word[i])){return false;}
     }
     return true;
 }
@@ -123,7 +152,10 @@ void HangmanWord :: reveal_part(){
     std::shuffle(indices.begin(), indices.end(), g);
     for (size_t i = 0; i < n_reveals && i < indices.size(); ++i) {
         size_t idx = indices[i];
-        m_masked_word[2 * idx] = m_secret_word[idx]; 
+        if (m_masked_word[2 * idx] == m_mask_char){
+            m_masked_word[2 * idx] = m_secret_word[idx];
+            m_n_masked--;
+        }
         m_open_letters.push_back(m_secret_word[idx]); 
     }
-}
\ No newline at end of file
+}
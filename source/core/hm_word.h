@@ -14,15 +14,42 @@
  * the end we may retrieve this information for score
  * (performance) calculation.
  *
+ * Guesses are handled with bit operations: letters are mapped to
+ * indices through the compile time table in alphabet.h, the letters
+ * of the secret word and the letters guessed so far are kept as
+ * masks, and initialize() links together the positions of each
+ * letter, so a hit reveals its positions without scanning the word
+ * and the number of masked letters is kept up to date as it goes.
+ *
+ * Once a word is set, guessing does not allocate: the mask is updated
+ * in place, the guess lists are stored inline and the accessors
+ * return views.
+ *
+ * The secret may be a phrase, such as "MESTRE DE OBRAS": it is masked
+ * per code point and anything that is not a letter (spaces, hyphens)
+ * is shown from the start. Accents are folded for matching, so
+ * guessing 'A' also reveals 'Ã' and 'Á', and 'C' reveals 'Ç'.
+ *
  * \author Selan
  * \date April 20th, 2022
  */
 
+#include <array>
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <iostream>
 
+#include "../utils/inline_vector.h"
+#include "alphabet.h"
+
 class HangmanWord {
+  //=== Public types
+public:
+  /// List of guesses, stored inline: each letter can only be guessed once.
+  using guess_list_t = InlineVector<wchar_t, alphabet::N_LETTERS>;
+
   //=== Data members or attributes.
 private:
   std::wstring m_secret_word;               //!< The secret word to guess.
@@ -31,8 +58,13 @@ private:
   long m_n_correct_guesses;                 //!< # of correct guesses made by the player.
   long m_n_wrong_guesses;                   //!< # of wrong guesses made by the player.
   wchar_t m_mask_char;                      //!< Char used as mask to hide letters in the secret word.
-  std :: vector<wchar_t> m_wrong_guesses;   //!< List of wrong guesses made.
-  std :: vector<wchar_t> m_correct_guesses; //!< List of correct guesses made.
+  guess_list_t m_wrong_guesses;             //!< List of wrong guesses made.
+  guess_list_t m_correct_guesses;           //!< List of correct guesses made.
+  alphabet::mask_t m_secret_letters = 0;    //!< Letters present in the secret word.
+  alphabet::mask_t m_guessed = 0;           //!< Letters guessed so far, right or wrong.
+  std :: array<int32_t, alphabet::N_LETTERS> m_first_pos{}; //!< First position of each letter, or -1.
+  std :: vector<int32_t> m_next_pos;        //!< Next position of the same letter, or -1.
+  size_t m_n_masked = 0;                    //!< # of letters still masked.
 
   //=== Public types
 public:
@@ -56,11 +88,19 @@ public:
   ~HangmanWord() = default;
   
   /// Initialize the object providing a (new) word, show letters and mask char.
-  void initialize(const std::wstring &sw, const std::wstring &ol = L"",
+  /*!
+   * Builds the letter masks and the letter -> positions table, and
+   * masks the word.
+   */
+  void initialize(std::wstring_view sw, std::wstring_view ol = L"",
+                  wchar_t mch = L'_');
+
+  /// Initialize the object from a word in UTF-8, as stored in the dictionary.
+  void initialize(std::string_view sw, std::wstring_view ol = L"",
                   wchar_t mch = L'_');
   
   /// Return a the secret word with the unguessed letters masked.
-  [[nodiscard]] std :: wstring masked_str() const{return m_masked_word;};
+  [[nodiscard]] std :: wstring_view masked_str() const{return m_masked_word;};
   
   /**
   * @brief Check the guess and return the result.
@@ -89,21 +129,21 @@ public:
    * 
    * @return The list of wrong guesses.
    */
-  [[nodiscard]] std :: vector<wchar_t> wrong_guesses_list() const{return m_wrong_guesses;};
+  [[nodiscard]] const guess_list_t& wrong_guesses_list() const{return m_wrong_guesses;};
 
   /**
    * @brief Return the list of correct guesses.
    * 
    * @return The list of correct guesses.
    */
-  std :: vector<wchar_t> correct_guesses_list() const{return m_correct_guesses;};
+  const guess_list_t& correct_guesses_list() const{return m_correct_guesses;};
   
   /**
    * @brief Return the number of masked letters in the secret word.
    * 
    * @return The number of masked characters.
    */
-  [[nodiscard]] size_t n_masked_ch() const;
+  [[nodiscard]] size_t n_masked_ch() const{return m_n_masked;};
   
   /**
    * @brief Return the mask character.
@@ -117,7 +157,7 @@ public:
    * 
    * @return The secret word.
    */
-  std::wstring operator()() const{return m_secret_word;};
+  std::wstring_view operator()() const{return m_secret_word;};
   
   /**
    * @brief Reset the object to its original state and mask the secret word.
@@ -148,14 +188,6 @@ public:
    */
   void add_correct_guess(wchar_t);
 
-  /**
-   * @brief Generate the masked word by masking unguessed letters.
-   */ 
-  void make_masked_word();
-
-  /// Get the choose word to be the secret word.
-  void get_word(std :: wstring word){m_secret_word = word;};
-
   /**
    * @brief Reveal a masked character.
    * 
@@ -164,7 +196,15 @@ public:
   void unmasked_char(wchar_t);
 
   /// Return the secret word.
-  std :: wstring secret_word() const{return m_secret_word;};
+  std :: wstring_view secret_word() const{return m_secret_word;};
+
+  /**
+   * @brief Check a guess of the whole word, ignoring accents.
+   * 
+   * @param word The guessed word, in upper case.
+   * @return true If it is the secret word.
+   */
+  [[nodiscard]] bool matches(std :: wstring_view word) const;
 
   /**
    * @brief Check if all characters are revealed.
@@ -172,7 +212,7 @@ public:
    * @return true If all characters are revealed.
    * @return false If there are still masked characters.
    */
-  bool all_unmasked();
+  bool all_unmasked() const{return m_n_masked == 0;};
 
   /**
    * @brief Reveal part of the secret word.
@@ -0,0 +1,70 @@
+/*!
+ * Leaderboard class implementation.
+ *
+ * \file leaderboard.cpp
+ */
+
+#include "leaderboard.h"
+
+uint64_t Leaderboard::value(order_e order, const Entry &entry) {
+  switch (order) {
+  case order_e::SCORE:
+    return entry.score;
+  case order_e::HARD:
+    return entry.hard;
+  case order_e::WIN_RATE: {
+    // Parts per million won in the high bits, wins in the low ones.
+    uint64_t games = uint64_t{entry.wins} + entry.loses;
+    uint64_t rate = games == 0 ? 0 : uint64_t{entry.wins} * 1000000 / games;
+    return rate << 32 | entry.wins;
+  }
+  case order_e::WORDS:
+    return entry.words;
+  }
+  return 0;
+}
+
+void Leaderboard::update(const Player &player) {
+  auto found = m_ids.find(player.m_name);
+  bool added = found == m_ids.end();
+  uint32_t id = added ? static_cast<uint32_t>(m_entries.size()) : found->second;
+  std::array<uint64_t, N_ORDERS> before{};
+  if (added) {
+    Entry &entry = m_entries.emplace_back();
+    entry.name = player.m_name;
+    m_ids.emplace(entry.name, id);
+  } else {
+    for (size_t o = 0; o < N_ORDERS; ++o) { before[o] = value(order_e(o), m_entries[id]); }
+  }
+
+  Entry &entry = m_entries[id];
+  entry.score = player.m_score;
+  entry.easy = static_cast<uint32_t>(player.m_easy);
+  entry.medium = static_cast<uint32_t>(player.m_medium);
+  entry.hard = static_cast<uint32_t>(player.m_hard);
+  entry.words = static_cast<uint32_t>(player.m_words);
+  entry.wins = static_cast<uint32_t>(player.m_wins);
+  entry.loses = static_cast<uint32_t>(player.m_loses);
+
+  for (size_t o = 0; o < N_ORDERS; ++o) {
+    uint64_t after = value(order_e(o), entry);
+    if (!added && after == before[o]) { continue; }
+    if (!added) { m_rankings[o].erase({before[o], id}); }
+    m_rankings[o].insert({after, id});
+  }
+}
+
+void Leaderboard::clear() {
+  for (Ranking &ranking : m_rankings) { ranking.clear(); }
+  m_ids.clear();
+  m_entries.clear();
+}
+
+size_t Leaderboard::rank(order_e order, std::wstring_view name) const {
+  auto found = m_ids.find(name);
+  if (found == m_ids.end()) { return 0; }
+  // Everyone with a higher value is ranked before the player; the key
+  // with id 0 sorts before every entry with the same value.
+  uint64_t v = value(order, m_entries[found->second]);
+  return m_rankings[static_cast<size_t>(order)].order_of_key({v, 0}) + 1;
+}
@@ -0,0 +1,134 @@
+#ifndef LEADERBOARD_H
+#define LEADERBOARD_H
+/*!
+ * Leaderboard class
+ * @file leaderboard.h
+ *
+ * Players ranked by score, hard games, win rate and words played, kept
+ * in order as players change instead of being sorted every time the
+ * scoreboard is shown. Each player has a small entry with its counters
+ * (its played words are not kept), and each order is an order
+ * statistic tree over the entries: a red-black tree whose nodes also
+ * count the nodes below them. Updating a player costs O(log n) per
+ * order whose value changed, a page of K players starting anywhere is
+ * read in O(log n + K) and a player's rank is found in O(log n).
+ *
+ * Players with the same value share a rank (1, 2, 2, 4, ...) and are
+ * listed in the order they joined the board.
+ */
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include <ext/pb_ds/assoc_container.hpp>
+#include <ext/pb_ds/tree_policy.hpp>
+
+#include "player.h"
+
+class Leaderboard {
+  //=== Public types
+public:
+  /// What the board keeps of a player.
+  struct Entry {
+    std::wstring name;   //!< Player::name().
+    uint64_t score = 0;  //!< Player::score().
+    uint32_t easy = 0;   //!< Player::easy_played().
+    uint32_t medium = 0; //!< Player::normal_played().
+    uint32_t hard = 0;   //!< Player::hard_played().
+    uint32_t words = 0;  //!< Player::n_words().
+    uint32_t wins = 0;   //!< Player::n_wins().
+    uint32_t loses = 0;  //!< Player::n_loses().
+  };
+
+  /// The orders players are ranked by, best first.
+  enum class order_e : uint8_t {
+    SCORE = 0, //!< Highest score.
+    HARD,      //!< Most games played on hard.
+    WIN_RATE,  //!< Highest share of games won; more wins breaks ties.
+    WORDS,     //!< Most words played.
+  };
+
+  /// Number of orders.
+  static constexpr size_t N_ORDERS = 4;
+
+  //=== Private types
+private:
+  /// Position of an entry in one order.
+  struct Key {
+    uint64_t value; //!< The entry's value in that order, see value().
+    uint32_t id;    //!< Index of the entry in m_entries.
+  };
+
+  /// Higher values first; ties in joining order.
+  struct ByValue {
+    bool operator()(const Key &a, const Key &b) const {
+      return a.value != b.value ? a.value > b.value : a.id < b.id;
+    }
+  };
+
+  /// Red-black tree of keys, with subtree sizes for order statistics.
+  using Ranking = __gnu_pbds::tree<Key, __gnu_pbds::null_type, ByValue, __gnu_pbds::rb_tree_tag,
+                                   __gnu_pbds::tree_order_statistics_node_update>;
+
+  //=== Data members
+  std::deque<Entry> m_entries;                           //!< Entries, by id; never move.
+  std::unordered_map<std::wstring_view, uint32_t> m_ids; //!< Name (in m_entries) -> id.
+  std::array<Ranking, N_ORDERS> m_rankings;              //!< Every entry, best first, per order.
+
+  //=== Public interface
+public:
+  Leaderboard() = default;
+  Leaderboard(const Leaderboard &) = delete;
+  Leaderboard &operator=(const Leaderboard &) = delete;
+
+  /// Add a player, or bring its entry up to date. O(log n).
+  void update(const Player &player);
+
+  /// Return the number of players on the board.
+  [[nodiscard]] size_t size() const { return m_entries.size(); }
+
+  /// Remove every player.
+  void clear();
+
+  /**
+   * @brief Return a player's rank.
+   *
+   * @param order The order to rank by.
+   * @param name The player's name.
+   * @return 1 for the best player, or 0 if the player is not on the board.
+   */
+  [[nodiscard]] size_t rank(order_e order, std::wstring_view name) const;
+
+  /**
+   * @brief Call `fn(rank, entry)` for a page of players, best first.
+   *
+   * @param order The order to rank by.
+   * @param first Position of the first player of the page, from 0.
+   * @param count Most players on the page.
+   */
+  template <typename Fn> void page(order_e order, size_t first, size_t count, Fn &&fn) const {
+    const Ranking &ranking = m_rankings[static_cast<size_t>(order)];
+    auto it = ranking.find_by_order(first);
+    if (it == ranking.end()) { return; }
+    // The page may start among players tied with earlier ones.
+    size_t rank = ranking.order_of_key({it->value, 0}) + 1;
+    uint64_t last = it->value;
+    for (size_t position = first; it != ranking.end() && position < first + count; ++it, ++position) {
+      if (it->value != last) { rank = position + 1; }
+      last = it->value;
+      fn(rank, static_cast<const Entry &>(m_entries[it->id]));
+    }
+  }
+
+  /// Call `fn(rank, entry)` for the `k` players with the highest score.
+  template <typename Fn> void top(size_t k, Fn &&fn) const { page(order_e::SCORE, 0, k, fn); }
+
+  /// Return an entry's value in an order: larger is better.
+  static uint64_t value(order_e order, const Entry &entry);
+};
+#endif
@@ -32,21 +32,52 @@
  */
 
 #include <cstdlib> // EXIT_SUCCESS
+#include <cstring>
 #include <iostream>
 #include <locale>
 
+#include <fcntl.h>
+#include <unistd.h>
+
 //#include "hangman_common.h"
 #include "hangman_gm.h"
 
+/// Print how the program is run, and fail.
+static int usage(const char *program) {
+  std::wcerr << L"Usage: " << program << L" [--words words.csv] [--players Players.dat]\n"
+             << L"       " << program << L" --headless [--words words.csv] [--players Players.dat] [script|-]\n"
+             << L"\n"
+             << L"--headless reads the commands typed in a game, one per line, from the\n"
+             << L"script (or standard input), draws nothing and prints one CSV line per\n"
+             << L"match. Quitting starts the next session; the run ends with the script.\n";
+  return EXIT_FAILURE;
+}
+
 int main(int argc, char *argv[]) {
   std::setlocale(LC_ALL, "pt_BR.utf8");
-  GameController hg;
+  GameOptions options;
+  const char *script = nullptr;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--headless") == 0) { options.headless = true; }
+    else if (std::strcmp(argv[i], "--words") == 0 && i + 1 < argc) { options.words_path = argv[++i]; }
+    else if (std::strcmp(argv[i], "--players") == 0 && i + 1 < argc) { options.players_path = argv[++i]; }
+    else if (script == nullptr && (argv[i][0] != '-' || argv[i][1] == '\0')) { script = argv[i]; }
+    else { return usage(argv[0]); }
+  }
+  if (script != nullptr && !options.headless) { return usage(argv[0]); }
+  if (script != nullptr && std::strcmp(script, "-") != 0) {
+    options.input_fd = ::open(script, O_RDONLY | O_CLOEXEC);
+    if (options.input_fd < 0) {
+      std::wcerr << L"Unable to open " << script << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  GameController hg(options);
 
   // The Game Loop.
   while (not hg.game_over()) {
     hg.process_events();
     hg.update();
-    system("clear");
     hg.render();
   }
   
@@ -0,0 +1,98 @@
+/*!
+ * Match class implementation.
+ *
+ * \file match.cpp
+ */
+
+#include <cwctype>
+
+#include "match.h"
+
+void Match::start(std::string_view word, uint32_t word_id, dificult_e dificult) {
+  m_word.initialize(word);
+  m_word_id = word_id;
+  m_dificult = dificult;
+  m_status = status_e::ON;
+  if (m_dificult == dificult_e::EASY) { m_word.reveal_part(); }
+}
+
+Match::guess_e Match::guess(wchar_t letter, Player &player) {
+  if (std::iswdigit(static_cast<wint_t>(letter))) { return guess_e::DIGIT; }
+  switch (m_word.guess(letter)) {
+  case HangmanWord::guess_e::REPEATED:
+    return guess_e::REPEATED;
+  case HangmanWord::guess_e::WRONG:
+    m_word.add_wrong_guess(letter);
+    player.decrease_score(scaled(10));
+    settle(player);
+    return guess_e::WRONG;
+  case HangmanWord::guess_e::CORRECT:
+    break;
+  }
+  m_word.add_correct_guess(letter);
+  m_word.unmasked_char(letter);
+  player.increase_score(scaled(10));
+  settle(player);
+  return guess_e::CORRECT;
+}
+
+bool Match::guess_word(std::wstring_view word, Player &player) {
+  if (!m_word.matches(word)) {
+    m_word.add_n_wrong_guess();
+    player.decrease_score(scaled(100));
+    settle(player);
+    return false;
+  }
+  // Worth more while most of the word is still hidden.
+  player.increase_score(m_word.secret_word().size() / 2 <= m_word.n_masked_ch() ? scaled(100) : scaled(10));
+  settle(player, true);
+  return true;
+}
+
+void Match::leave(Player &player) {
+  if (m_status != status_e::ON) { return; }
+  m_status = status_e::LOST;
+  finish(player);
+}
+
+size_t Match::scaled(size_t points) const {
+  switch (m_dificult) {
+  case dificult_e::EASY:
+    return points / 2;
+  case dificult_e::NORMAL:
+    return points;
+  case dificult_e::HARD:
+    return points * 2;
+  }
+  return points;
+}
+
+void Match::settle(Player &player, bool guessed_word) {
+  if (m_status != status_e::ON) { return; }
+  if (m_word.wrong_guesses() >= MAX_MISTAKES) { m_status = status_e::LOST; }
+  else if (guessed_word || m_word.all_unmasked()) { m_status = status_e::WON; }
+  else { return; }
+  finish(player);
+}
+
+void Match::finish(Player &player) {
+  player.add_n_words();
+  if (m_status == status_e::WON) {
+    player.add_wins();
+    player.increase_score(scaled(1000));
+  } else {
+    player.add_loses();
+    player.decrease_score(scaled(1000));
+  }
+  switch (m_dificult) {
+  case dificult_e::EASY:
+    player.add_easy_played();
+    break;
+  case dificult_e::NORMAL:
+    player.add_medium_played();
+    break;
+  case dificult_e::HARD:
+    player.add_hard_played();
+    break;
+  }
+}
@@ -0,0 +1,120 @@
+#ifndef MATCH_H
+#define MATCH_H
+/*!
+ * Match class
+ * @file match.h
+ *
+ * One round of hangman: the secret word, the guesses made on it and
+ * the rules that score them. Every guess is applied to the player right
+ * away; once the match is decided the player's counters (words, wins
+ * or loses, games per dificult) and the final bonus or penalty are
+ * applied too, exactly once.
+ *
+ * Points depend on the dificult, and are halved on easy and doubled on
+ * hard:
+ *  - a letter: +10 if it is in the word, -10 if not;
+ *  - the whole word: +100 while half of it or more is still masked,
+ *    +10 later, and -100 (and a wrong guess) if it is not the word;
+ *  - the match: +1000 for a win, -1000 for a loss.
+ *
+ * A Match does no input or output; guessing does not allocate.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "hm_word.h"
+#include "player.h"
+
+class Match {
+  //=== Public types
+public:
+  /// The dificult options.
+  enum class dificult_e : short {
+    NORMAL = 0, //!< Medium dificult with none letters reveal.
+    EASY,       //!< Easiest dificult with some letters reveal.
+    HARD,       //!< Hardest dificult with complex words.
+  };
+
+  /// The match status.
+  enum class status_e : short {
+    ON = 1, //!< Match still open and running.
+    WON,    //!< Match ended and player WON.
+    LOST,   //!< Match ended and player LOST.
+  };
+
+  /// What became of a letter guess.
+  enum class guess_e : short {
+    CORRECT = 0, //!< The letter is in the word.
+    WRONG,       //!< It is not.
+    REPEATED,    //!< It was guessed before; nothing changed.
+    DIGIT,       //!< Digits are not guesses; nothing changed.
+  };
+
+  /// Wrong guesses that lose the match.
+  static constexpr size_t MAX_MISTAKES = 6;
+
+  //=== Data members
+private:
+  HangmanWord m_word;                         //!< The word, masked as guessed so far.
+  uint32_t m_word_id = 0;                     //!< Dictionary id of the word.
+  dificult_e m_dificult = dificult_e::NORMAL; //!< Dificult it is played on.
+  status_e m_status = status_e::LOST;         //!< Status; no match is on before start().
+
+  //=== Public interface
+public:
+  /**
+   * @brief Start a match on a word, revealing part of it on easy.
+   *
+   * @param word The word, in UTF-8, as stored in the dictionary.
+   * @param word_id Its dictionary id.
+   * @param dificult Dificult it is played on.
+   */
+  void start(std::string_view word, uint32_t word_id, dificult_e dificult);
+
+  /**
+   * @brief Guess a letter, scoring it for `player`.
+   *
+   * @param letter The letter, upper cased.
+   * @param player The player, whose score and counters change.
+   * @return What became of the guess.
+   */
+  guess_e guess(wchar_t letter, Player &player);
+
+  /**
+   * @brief Guess the whole word, scoring it for `player`.
+   *
+   * @param word The word, upper cased.
+   * @param player The player, whose score and counters change.
+   * @return true if it is the word.
+   */
+  bool guess_word(std::wstring_view word, Player &player);
+
+  /// Give the match up, which loses it.
+  void leave(Player &player);
+
+  /// Return the status.
+  [[nodiscard]] status_e status() const { return m_status; }
+
+  /// Return the word, masked as guessed so far.
+  [[nodiscard]] const HangmanWord &word() const { return m_word; }
+
+  /// Return the dictionary id of the word.
+  [[nodiscard]] uint32_t word_id() const { return m_word_id; }
+
+  /// Return the dificult the match is played on.
+  [[nodiscard]] dificult_e dificult() const { return m_dificult; }
+
+private:
+  /// Return `points` (for normal), scaled by the dificult.
+  [[nodiscard]] size_t scaled(size_t points) const;
+
+  /// Decide the match if it is over, then apply the result to the player.
+  void settle(Player &player, bool guessed_word = false);
+
+  /// Apply the result of a decided match to the player.
+  void finish(Player &player);
+};
+
+#endif
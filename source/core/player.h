@@ -2,7 +2,7 @@
 #define _PLAYER_H_
 
 #include <cstddef>
-#include <set>
+#include <cstdint>
 #include <string>
 #include <utility>
 #include <iostream>
@@ -11,15 +11,22 @@
 #include <unordered_map>
 
 //#include "hangman_common.h"
+#include "word_set.h"
+
+class Dictionary;
 
 /// Representing a single player.
 class Player {
+  friend class Leaderboard;
+  friend class PlayerJournal;
+  friend class PlayerStore;
+
   //=== Private members.
 private:
   
   std::wstring m_name;                   //!< The player's name
   size_t m_score{};                      //!< The player's total score.
-  std::set<std::wstring> m_played_words; //!< List of words played in a game.
+  WordSet m_played_words;                //!< Dictionary ids of the words played in a game.
   size_t m_medium{};                     //!< Number of games played on medium.
   size_t m_easy{};                       //!< Number of games played on easy.
   size_t m_hard{};                       //!< Number of games played on hard.
@@ -63,17 +70,17 @@ public:
   /**
    * @brief Add a word to the list of words played by the player.
    * 
-   * @param w The word to add.
+   * @param id The dictionary id of the word to add.
    */
-  void add_word(const std::wstring & w);
+  void add_word(uint32_t id);
   
   /**
    * @brief Check if the player has played a specific word before.
    * 
-   * @param w The word to check.
+   * @param id The dictionary id of the word to check.
    * @return true if the player has played the word before, false otherwise.
    */
-  bool has_played(const std::wstring &) const;
+  bool has_played(uint32_t id) const;
 
   /**
    * @brief Clear the list of words played by the player.
@@ -132,7 +139,7 @@ public:
    * 
    * @return The set of played words.
    */
-  std :: set<std :: wstring> get_played_words() const{return m_played_words;};
+  const WordSet& get_played_words() const{return m_played_words;};
 
   /**
    * @brief Increases the number of games played on easy difficulty.
@@ -161,10 +168,14 @@ public:
 
   /**
    * @brief Read player data from a text file.
+   *
+   * Records written before played words were saved as dictionary ids
+   * list the words themselves; those are looked up in the dictionary.
    * 
-   * @param file The input file stream to read from.
+   * @param file The input stream to read from.
+   * @param dictionary The dictionary the played word ids refer to.
    */
-  void read_file(std::wifstream& file);
+  void read_file(std::wistream& file, const Dictionary& dictionary);
 
   /**
    * @brief Write player data to a text file.
@@ -173,34 +184,6 @@ public:
    */
   void write_file(std :: wofstream& file) const;
 
-  /**
-   * @brief Retrieve all players from a text file.
-   * 
-   * @return An unordered map containing player names as keys and Player objects as values.
-   */
-  std :: unordered_map<std :: wstring, Player> get_players();
-
-  /**
-   * @brief Find a player in a map of players and update the current player's data if found.
-   * 
-   * @param players The map of players to search within.
-   */
-  void find_player(const std :: unordered_map<std :: wstring, Player>&);
-
-  /**
-   * @brief Update a player's data in a map of players.
-   * 
-   * @param players The map of players to update.
-   */
-  void update_player(std :: unordered_map<std :: wstring, Player>&) const;
-
-  /**
-  * @brief Write all players from a map of players to a text file.
-  * 
-  * @param players The map of players to write.
-  */
-  void write_all(const std :: unordered_map<std :: wstring, Player>&) const;
-
   /**
    * @brief Increase the player's score by a specified amount.
    * 
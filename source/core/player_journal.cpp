@@ -0,0 +1,242 @@
+/*!
+ * Player journal class implementation.
+ *
+ * \file player_journal.cpp
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../utils/mapped_file.h"
+#include "../utils/utf8.h"
+#include "dictionary.h"
+#include "player_journal.h"
+#include "player_store.h"
+
+namespace {
+/// FNV-1a hash of a run of bytes.
+uint32_t checksum(const char *data, size_t size) {
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < size; ++i) {
+    hash = (hash ^ static_cast<unsigned char>(data[i])) * 16777619u;
+  }
+  return hash;
+}
+
+/// Append the raw bytes of `value` to `out`.
+template <typename T> void put(std::string &out, T value) {
+  out.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+/// Read a `T` at `offset` bytes into `data`.
+template <typename T> T get(const char *data, size_t offset) {
+  T value;
+  std::memcpy(&value, data + offset, sizeof(value));
+  return value;
+}
+
+/// Return whether a file exists.
+bool exists(const std::string &path) {
+  struct stat st {};
+  return ::stat(path.c_str(), &st) == 0;
+}
+} // namespace
+
+PlayerJournal::PlayerJournal(std::string store_path, std::string journal_path,
+                             std::string index_path)
+    : m_store_path(std::move(store_path)),
+      m_index_path(std::move(index_path)),
+      m_journal_path(std::move(journal_path)),
+      m_rotated_path(m_journal_path + ".old") {
+  struct stat st {};
+  if (::stat(m_journal_path.c_str(), &st) == 0) { m_size = static_cast<size_t>(st.st_size); }
+}
+
+PlayerJournal::~PlayerJournal() {
+  wait();
+  if (m_fd >= 0) { ::close(m_fd); }
+}
+
+template <typename Fn> size_t PlayerJournal::scan(const std::string &path, Fn &&fn, size_t checked) {
+  MappedFile file(path.c_str());
+  if (!file.is_open()) { return 0; }
+  const char *data = file.data();
+  size_t size = file.size();
+  size_t pos = 0;
+  while (pos + RECORD_SIZE <= size) {
+    const char *record = data + pos;
+    auto name_size = get<uint16_t>(record, 4);
+    size_t length = RECORD_SIZE + name_size;
+    if (length > size - pos ||
+        (pos + length > checked &&
+         checksum(record + 4, length - 4) != get<uint32_t>(record, 0))) {
+      break; // Torn write at the end of the journal.
+    }
+    fn(std::string_view(record + RECORD_SIZE, name_size), record);
+    pos += length;
+  }
+  return pos;
+}
+
+size_t PlayerJournal::truncate_torn(const std::string &path) {
+  size_t valid = scan(path, [](std::string_view, const char *) {});
+  struct stat st {};
+  if (::stat(path.c_str(), &st) == 0 && static_cast<size_t>(st.st_size) > valid) {
+    if (::truncate(path.c_str(), static_cast<off_t>(valid)) != 0) { return static_cast<size_t>(st.st_size); }
+  }
+  return valid;
+}
+
+void PlayerJournal::apply(const char *record, Player &player) {
+  auto event = static_cast<event_e>(get<uint8_t>(record, 6));
+  if (event == event_e::WORDS_CLEARED) { player.m_played_words.clear(); }
+  auto word = get<uint32_t>(record, 8);
+  if (event == event_e::MATCH_STARTED && word != Dictionary::NO_WORD) {
+    player.m_played_words.insert(word);
+  }
+  player.m_score = get<uint64_t>(record, 12);
+  player.m_easy = get<uint32_t>(record, 20);
+  player.m_medium = get<uint32_t>(record, 24);
+  player.m_hard = get<uint32_t>(record, 28);
+  player.m_words = get<uint32_t>(record, 32);
+  player.m_wins = get<uint32_t>(record, 36);
+  player.m_loses = get<uint32_t>(record, 40);
+}
+
+void PlayerJournal::replay(std::unordered_map<std::wstring, Player> &players) const {
+  std::wstring name;
+  auto replay_record = [&](std::string_view utf8_name, const char *record) {
+    utf8::decode(name, utf8_name);
+    apply(record, players.try_emplace(name, name).first->second);
+  };
+  scan(m_rotated_path, replay_record);
+  scan(m_journal_path, replay_record);
+}
+
+bool PlayerJournal::replay(Player &player) const {
+  std::string key;
+  utf8::encode(key, player.m_name);
+  bool found = false;
+  auto replay_record = [&](std::string_view utf8_name, const char *record) {
+    if (utf8_name != key) { return; }
+    apply(record, player);
+    found = true;
+  };
+  scan(m_rotated_path, replay_record);
+  // Once appending, the live journal was cut to its whole records, and
+  // only whole ones were added: a login replays it by name alone.
+  scan(m_journal_path, replay_record, m_fd >= 0 ? m_size : 0);
+  return found;
+}
+
+bool PlayerJournal::append(const Player &player, event_e event, uint32_t word) {
+  if (m_fd < 0) {
+    // Records appended after a torn one would never be replayed.
+    m_size = truncate_torn(m_journal_path);
+    m_fd = ::open(m_journal_path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (m_fd < 0) { return false; }
+  }
+  m_record.clear();
+  put<uint32_t>(m_record, 0); // Checksum, filled in below.
+  put<uint16_t>(m_record, 0); // Name size, likewise.
+  put<uint8_t>(m_record, static_cast<uint8_t>(event));
+  put<uint8_t>(m_record, 0);
+  put<uint32_t>(m_record, word);
+  put<uint64_t>(m_record, player.m_score);
+  put<uint32_t>(m_record, static_cast<uint32_t>(player.m_easy));
+  put<uint32_t>(m_record, static_cast<uint32_t>(player.m_medium));
+  put<uint32_t>(m_record, static_cast<uint32_t>(player.m_hard));
+  put<uint32_t>(m_record, static_cast<uint32_t>(player.m_words));
+  put<uint32_t>(m_record, static_cast<uint32_t>(player.m_wins));
+  put<uint32_t>(m_record, static_cast<uint32_t>(player.m_loses));
+  utf8::encode(m_record, player.m_name);
+  // The name size has 16 bits; a longer name would be cut there and the
+  // record, failing its checksum, taken for a torn tail.
+  if (m_record.size() - RECORD_SIZE > UINT16_MAX) { return false; }
+  auto name_size = static_cast<uint16_t>(m_record.size() - RECORD_SIZE);
+  std::memcpy(&m_record[4], &name_size, sizeof(name_size));
+  uint32_t sum = checksum(m_record.data() + 4, m_record.size() - 4);
+  std::memcpy(&m_record[0], &sum, sizeof(sum));
+
+  // A single write with O_APPEND: the record lands whole or, on a
+  // crash, as a torn tail that replay ignores.
+  ssize_t written = ::write(m_fd, m_record.data(), m_record.size());
+  if (written != static_cast<ssize_t>(m_record.size())) { return false; }
+  m_size += m_record.size();
+  return true;
+}
+
+void PlayerJournal::compact() {
+  if (m_compacting) { return; }
+  wait();
+  if (m_fd >= 0) {
+    ::close(m_fd);
+    m_fd = -1;
+  }
+  if (exists(m_rotated_path)) {
+    // A rotated journal left by an interrupted compaction: the live one
+    // goes after it, and both are folded together.
+    if (m_size != 0 && !merge_into_rotated()) { return; }
+  } else {
+    if (m_size == 0) { return; }
+    if (std::rename(m_journal_path.c_str(), m_rotated_path.c_str()) != 0) { return; }
+  }
+  m_size = 0;
+  m_compacting = true;
+  m_compactor = std::thread([this] {
+    if (fold()) {
+      std::remove(m_rotated_path.c_str());
+    }
+    m_compacting = false;
+  });
+}
+
+bool PlayerJournal::merge_into_rotated() {
+  size_t rotated = truncate_torn(m_rotated_path);
+  MappedFile live(m_journal_path.c_str());
+  if (!live.is_open()) { return false; }
+  size_t valid = scan(m_journal_path, [](std::string_view, const char *) {});
+  int fd = ::open(m_rotated_path.c_str(), O_WRONLY | O_APPEND | O_CLOEXEC);
+  if (fd < 0) { return false; }
+  bool ok = ::write(fd, live.data(), valid) == static_cast<ssize_t>(valid) && ::fsync(fd) == 0;
+  ::close(fd);
+  if (!ok) {
+    // Leave both files as they were: the rotated one ends where it did.
+    int restored = ::truncate(m_rotated_path.c_str(), static_cast<off_t>(rotated));
+    (void)restored;
+    return false;
+  }
+  return std::remove(m_journal_path.c_str()) == 0;
+}
+
+void PlayerJournal::wait() {
+  if (m_compactor.joinable()) { m_compactor.join(); }
+}
+
+bool PlayerJournal::fold() const {
+  PlayerStore store(m_store_path, m_index_path);
+  if (!store.open()) { return false; }
+  // Each player touched by the journal is read once, brought up to date
+  // and written back in place.
+  std::unordered_map<std::wstring, Player> players;
+  std::wstring name;
+  scan(m_rotated_path, [&](std::string_view utf8_name, const char *record) {
+    utf8::decode(name, utf8_name);
+    auto [it, inserted] = players.try_emplace(name, name);
+    if (inserted) { store.load(name, it->second); }
+    apply(record, it->second);
+  });
+  for (const auto &[name, player] : players) {
+    if (!store.save(player)) { return false; }
+  }
+  store.sync();
+  if (store.unindexed() > PlayerStore::INDEX_SLACK) { store.write_index(); }
+  return true;
+}
@@ -0,0 +1,160 @@
+#ifndef PLAYER_JOURNAL_H
+#define PLAYER_JOURNAL_H
+/*!
+ * Player journal class
+ * @file player_journal.h
+ *
+ * Keeps the player data on disk without ever writing it in the
+ * foreground. The player store (Players.dat, see player_store.h) is a
+ * *snapshot*; every change made during a session (a player joining, a
+ * match starting or ending, a played word list being cleared) is
+ * appended to a binary *journal* as a single small record, so a crash
+ * loses at most the match in progress.
+ *
+ * A player loaded from the snapshot has the journal replayed over it
+ * before play. A compactor thread then folds the journal into the
+ * snapshot: the journal is first rotated (renamed to `<journal>.old`,
+ * new records go to a fresh journal), the players it touches are
+ * updated in place in the store and flushed, and only then is the
+ * rotated journal removed.
+ *
+ * Records carry the player's counters *after* the event rather than
+ * the deltas, so replaying a record twice is harmless. That is what
+ * makes an interrupted fold safe: the rotated journal is simply folded
+ * again over a snapshot that may already have some of it.
+ *
+ * Record layout (native endianness), followed by the name in UTF-8:
+ * ```
+ *  uint32_t checksum      FNV-1a of everything after it, name included
+ *  uint16_t name_size
+ *  uint8_t  event
+ *  uint8_t  reserved
+ *  uint32_t word          word id played, or Dictionary::NO_WORD
+ *  uint64_t score
+ *  uint32_t easy, medium, hard, words, wins, loses
+ * ```
+ * A torn record at the end of a journal fails its checksum and ends
+ * the replay; it is cut off before anything is appended after it.
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#include "player.h"
+
+class PlayerJournal {
+  //=== Public types
+public:
+  /// What caused a record to be written.
+  enum class event_e : uint8_t {
+    JOINED = 1,    //!< A new player logged in.
+    MATCH_STARTED, //!< A word was drawn; the record carries its id.
+    MATCH_ENDED,   //!< A match was won or lost.
+    WORDS_CLEARED, //!< The played word list was cleared.
+  };
+
+  /// Size of the fixed part of a record, in bytes.
+  static constexpr size_t RECORD_SIZE = 44;
+  /// Journal size past which a session compacts it in the background.
+  static constexpr size_t COMPACT_THRESHOLD = size_t{1} << 20;
+
+  //=== Data members
+private:
+  std::string m_store_path;                //!< Players.dat.
+  std::string m_index_path;                //!< Players.idx.
+  std::string m_journal_path;              //!< Live journal.
+  std::string m_rotated_path;              //!< Journal being compacted.
+  int m_fd = -1;                           //!< Live journal, opened for appending.
+  size_t m_size = 0;                       //!< Bytes in the live journal.
+  std::string m_record;                    //!< Buffer for the record being written.
+  std::thread m_compactor;                 //!< Background compaction, if any.
+  std::atomic<bool> m_compacting{false};   //!< Whether m_compactor is still running.
+
+  //=== Public interface
+public:
+  /**
+   * @brief Create a journal for a player store.
+   *
+   * @param store_path The player store.
+   * @param journal_path The journal file, created on the first append.
+   * @param index_path The store index.
+   */
+  PlayerJournal(std::string store_path = "Players.dat",
+                std::string journal_path = "Players.journal",
+                std::string index_path = "Players.idx");
+  PlayerJournal(const PlayerJournal &) = delete;
+  PlayerJournal &operator=(const PlayerJournal &) = delete;
+  /// Waits for a running compaction and closes the journal.
+  ~PlayerJournal();
+
+  /**
+   * @brief Replay the journals over players loaded from the snapshot.
+   *
+   * A rotated journal left by an interrupted compaction is replayed
+   * first, then the live one.
+   *
+   * @param players The players read from the store.
+   */
+  void replay(std::unordered_map<std::wstring, Player> &players) const;
+
+  /**
+   * @brief Replay the journals over a single player.
+   *
+   * @param player The player, as read from the store (or new).
+   * @return true if the journals have records for the player.
+   */
+  bool replay(Player &player) const;
+
+  /**
+   * @brief Append a record with the player's current state.
+   *
+   * @param player The player that changed.
+   * @param event What changed.
+   * @param word The word drawn, for MATCH_STARTED.
+   * @return false if the record could not be written, or if the name
+   * takes more than UINT16_MAX bytes in UTF-8.
+   */
+  bool append(const Player &player, event_e event, uint32_t word = UINT32_MAX);
+
+  /**
+   * @brief Fold the journal into the player store, in the background.
+   *
+   * Does nothing if the journal is empty or a compaction is running.
+   */
+  void compact();
+
+  /// Wait for a running compaction to finish.
+  void wait();
+
+  /// Return the size of the live journal, in bytes.
+  [[nodiscard]] size_t size() const { return m_size; }
+
+private:
+  /**
+   * @brief Call `fn(name, record)` for every valid record of a journal file.
+   *
+   * @param path The journal file.
+   * @param fn Receives the UTF-8 name and the fixed part of each record.
+   * @param checked Bytes from the start known to hold whole records,
+   * whose checksums are not checked again.
+   * @return The size of the valid records, from the start of the file.
+   */
+  template <typename Fn> static size_t scan(const std::string &path, Fn &&fn, size_t checked = 0);
+
+  /// Cut a journal file after its last valid record; return its new size.
+  static size_t truncate_torn(const std::string &path);
+
+  /// Move the live journal to the end of the rotated one, and start a new one.
+  bool merge_into_rotated();
+
+  /// Apply the fixed part of a record to a player.
+  static void apply(const char *record, Player &player);
+
+  /// Apply the rotated journal to the player store.
+  bool fold() const;
+};
+#endif
@@ -0,0 +1,305 @@
+/*!
+ * Player store class implementation.
+ *
+ * \file player_store.cpp
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+#include <sys/stat.h>
+
+#include "../utils/utf8.h"
+#include "dictionary.h"
+#include "player_store.h"
+
+namespace {
+/// Round `n` up to a multiple of 8.
+uint64_t align8(uint64_t n) { return (n + 7) & ~uint64_t{7}; }
+
+/// Played words block size for `used` bytes, with room to grow.
+uint32_t words_capacity(size_t used) {
+  return static_cast<uint32_t>(align8(std::max<size_t>(16, used * 2)));
+}
+} // namespace
+
+PlayerStore::PlayerStore(std::string data_path, std::string index_path)
+    : m_data_path(std::move(data_path)), m_index_path(std::move(index_path)) {}
+
+uint64_t PlayerStore::hash(std::string_view utf8_name) {
+  uint64_t h = 14695981039346656037ull;
+  for (char c : utf8_name) { h = (h ^ static_cast<unsigned char>(c)) * 1099511628211ull; }
+  return h;
+}
+
+bool PlayerStore::exists() const {
+  struct stat st {};
+  return ::stat(m_data_path.c_str(), &st) == 0 && st.st_size > 0;
+}
+
+const PlayerStore::Header *PlayerStore::header() const {
+  return m_data.size() >= sizeof(Header) ? reinterpret_cast<const Header *>(m_data.data())
+                                         : nullptr;
+}
+
+bool PlayerStore::open() {
+  m_index.close();
+  if (!m_data.open(m_data_path.c_str())) { return false; }
+  if (m_data.size() == 0) {
+    if (!m_data.resize(4096)) { return false; }
+    Header header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.file_id = (static_cast<uint64_t>(std::random_device{}()) << 32) | std::random_device{}();
+    header.end = sizeof(Header);
+    std::memcpy(m_data.data(), &header, sizeof(header));
+  }
+  const Header *header = this->header();
+  if (header == nullptr || std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 ||
+      header->version != VERSION || header->end > m_data.size()) {
+    m_data.close();
+    return false;
+  }
+  auto index_is_current = [this, header] {
+    if (!m_index.is_open() || m_index.size() < sizeof(IndexHeader)) { return false; }
+    const auto *index = reinterpret_cast<const IndexHeader *>(m_index.data());
+    return std::memcmp(index->magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) == 0 &&
+           index->version == VERSION && index->file_id == header->file_id &&
+           index->covered_end <= header->end && index->covered_end % 8 == 0 &&
+           m_index.size() == sizeof(IndexHeader) + index->n_entries * sizeof(Entry);
+  };
+  m_index.open(m_index_path.c_str());
+  if (index_is_current()) { return true; }
+  m_index.close();
+  return write_index();
+}
+
+size_t PlayerStore::size() const {
+  const Header *header = this->header();
+  return header != nullptr ? header->n_players : 0;
+}
+
+size_t PlayerStore::unindexed() const {
+  size_t indexed = 0;
+  if (m_index.size() >= sizeof(IndexHeader)) {
+    indexed = reinterpret_cast<const IndexHeader *>(m_index.data())->n_entries;
+  }
+  return size() - std::min(size(), indexed);
+}
+
+bool PlayerStore::write_index() {
+  const Header *header = this->header();
+  if (header == nullptr) { return false; }
+  std::vector<Entry> entries;
+  entries.reserve(header->n_players);
+  for_each_chunk([&](uint64_t offset, const ChunkHeader &chunk) {
+    if (chunk.kind != PLAYER || !is_record(offset)) { return; }
+    entries.push_back({reinterpret_cast<const Record *>(m_data.data() + offset)->hash, offset});
+  });
+  std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) {
+    return a.hash != b.hash ? a.hash < b.hash : a.offset < b.offset;
+  });
+  IndexHeader index{};
+  std::memcpy(index.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+  index.version = VERSION;
+  index.file_id = header->file_id;
+  index.n_entries = entries.size();
+  index.covered_end = header->end;
+
+  std::string temp_path = m_index_path + ".tmp";
+  {
+    std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char *>(&index), sizeof(index));
+    file.write(reinterpret_cast<const char *>(entries.data()),
+               static_cast<std::streamsize>(entries.size() * sizeof(Entry)));
+    if (!file) { return false; }
+  }
+  if (std::rename(temp_path.c_str(), m_index_path.c_str()) != 0) { return false; }
+  return m_index.open(m_index_path.c_str());
+}
+
+uint64_t PlayerStore::find(std::string_view utf8_name) const {
+  const Header *header = this->header();
+  if (header == nullptr) { return 0; }
+  uint64_t h = hash(utf8_name);
+  auto matches = [&](uint64_t offset) {
+    if (!is_record(offset)) { return false; }
+    const auto *record = reinterpret_cast<const Record *>(m_data.data() + offset);
+    return record->hash == h && record->name_size == utf8_name.size() &&
+           std::memcmp(record + 1, utf8_name.data(), utf8_name.size()) == 0;
+  };
+
+  uint64_t covered_end = 0;
+  if (m_index.size() >= sizeof(IndexHeader)) {
+    const auto *index = reinterpret_cast<const IndexHeader *>(m_index.data());
+    const auto *first = reinterpret_cast<const Entry *>(index + 1);
+    const auto *last = first + index->n_entries;
+    const auto *it = std::lower_bound(first, last, h,
+                                      [](const Entry &e, uint64_t value) { return e.hash < value; });
+    for (; it != last && it->hash == h; ++it) {
+      if (matches(it->offset)) { return it->offset; }
+    }
+    covered_end = index->covered_end;
+  }
+  // Players added since the index was written.
+  uint64_t found = 0;
+  for_each_chunk(
+      [&](uint64_t offset, const ChunkHeader &chunk) {
+        if (found == 0 && chunk.kind == PLAYER && matches(offset)) { found = offset; }
+      },
+      covered_end);
+  return found;
+}
+
+bool PlayerStore::is_record(uint64_t offset) const {
+  const Header *header = this->header();
+  // Index entries are not trusted either: the offset itself is checked.
+  uint64_t end = std::min<uint64_t>(header->end, m_data.size());
+  if (offset % 8 != 0 || offset < sizeof(Header) + sizeof(ChunkHeader) || offset > end) { return false; }
+  const auto *chunk = reinterpret_cast<const ChunkHeader *>(m_data.data() + offset - sizeof(ChunkHeader));
+  if (chunk->kind != PLAYER || chunk->size > end - offset || chunk->size < sizeof(Record)) { return false; }
+  const auto *record = reinterpret_cast<const Record *>(m_data.data() + offset);
+  return record->name_size <= chunk->size - sizeof(Record) && record->words_size <= record->words_capacity &&
+         record->words_off >= sizeof(Header) && record->words_off <= end &&
+         record->words_capacity <= end - record->words_off;
+}
+
+void PlayerStore::read(uint64_t offset, Player &player) const {
+  const auto *record = reinterpret_cast<const Record *>(m_data.data() + offset);
+  const char *name = reinterpret_cast<const char *>(record + 1);
+  utf8::decode(player.m_name, std::string_view(name, record->name_size));
+  player.m_score = record->score;
+  player.m_easy = record->easy;
+  player.m_medium = record->medium;
+  player.m_hard = record->hard;
+  player.m_words = record->words;
+  player.m_wins = record->wins;
+  player.m_loses = record->loses;
+  player.m_played_words.decode(
+      std::string_view(m_data.data() + record->words_off, record->words_size));
+}
+
+bool PlayerStore::load(std::wstring_view name, Player &player) const {
+  std::string key;
+  utf8::encode(key, name);
+  uint64_t offset = find(key);
+  if (offset == 0) { return false; }
+  read(offset, player);
+  return true;
+}
+
+void PlayerStore::write_counters(const Player &player, Record &record) {
+  record.score = player.m_score;
+  record.easy = static_cast<uint32_t>(player.m_easy);
+  record.medium = static_cast<uint32_t>(player.m_medium);
+  record.hard = static_cast<uint32_t>(player.m_hard);
+  record.words = static_cast<uint32_t>(player.m_words);
+  record.wins = static_cast<uint32_t>(player.m_wins);
+  record.loses = static_cast<uint32_t>(player.m_loses);
+}
+
+uint64_t PlayerStore::allocate(chunk_e kind, size_t payload) {
+  payload = align8(payload);
+  uint64_t start = header()->end;
+  uint64_t end = start + sizeof(ChunkHeader) + payload;
+  if (end > m_data.size()) {
+    size_t size = std::max<size_t>(m_data.size() * 2, align8(end));
+    if (!m_data.resize(size)) { return 0; }
+  }
+  ChunkHeader chunk{kind, static_cast<uint32_t>(payload)};
+  std::memcpy(m_data.data() + start, &chunk, sizeof(chunk));
+  return start + sizeof(ChunkHeader);
+}
+
+void PlayerStore::commit(uint64_t end, bool player) {
+  auto *header = reinterpret_cast<Header *>(m_data.data());
+  if (player) { header->n_players++; }
+  header->end = end;
+}
+
+bool PlayerStore::append(const Player &player) {
+  std::string &name = m_buffer;
+  name.clear();
+  utf8::encode(name, player.m_name);
+  size_t name_size = name.size();
+  player.m_played_words.encode(name); // Right after the name.
+  size_t words_size = name.size() - name_size;
+  uint32_t capacity = words_capacity(words_size);
+
+  size_t payload = sizeof(Record) + name_size + capacity;
+  uint64_t offset = allocate(PLAYER, payload);
+  if (offset == 0) { return false; }
+  Record record{};
+  record.hash = hash(std::string_view(name).substr(0, name_size));
+  write_counters(player, record);
+  record.name_size = static_cast<uint32_t>(name_size);
+  record.words_size = static_cast<uint32_t>(words_size);
+  record.words_capacity = capacity;
+  record.words_off = offset + sizeof(Record) + name_size;
+  char *data = m_data.data() + offset;
+  std::memcpy(data, &record, sizeof(record));
+  std::memcpy(data + sizeof(Record), name.data(), name.size());
+  commit(offset + align8(payload), true);
+  return true;
+}
+
+bool PlayerStore::save(const Player &player) {
+  if (header() == nullptr) { return false; }
+  std::string &words = m_buffer;
+  words.clear();
+  utf8::encode(words, player.m_name);
+  uint64_t offset = find(words);
+  if (offset == 0) { return append(player); }
+
+  words.clear();
+  player.m_played_words.encode(words);
+  auto *record = reinterpret_cast<Record *>(m_data.data() + offset);
+  if (words.size() > record->words_capacity) {
+    // Outgrown: move the block to a new chunk, then point the record at it.
+    uint32_t capacity = words_capacity(words.size());
+    uint64_t block = allocate(WORDS, capacity);
+    if (block == 0) { return false; }
+    std::memcpy(m_data.data() + block, words.data(), words.size());
+    commit(block + capacity, false);
+    record = reinterpret_cast<Record *>(m_data.data() + offset); // The file may have moved.
+    record->words_off = block;
+    record->words_capacity = capacity;
+  } else {
+    std::memcpy(m_data.data() + record->words_off, words.data(), words.size());
+  }
+  record->words_size = static_cast<uint32_t>(words.size());
+  write_counters(player, *record);
+  return true;
+}
+
+bool PlayerStore::import_text(const char *text_path, const Dictionary &dictionary) {
+  std::wifstream file(text_path);
+  if (!file) { return false; }
+  // Into an empty store, names only need checking against each other.
+  bool fresh = size() == 0;
+  std::unordered_set<std::wstring> seen;
+  while (file && file.peek() != WEOF) {
+    Player player;
+    player.read_file(file, dictionary);
+    if (!seen.insert(player.name()).second) { continue; }
+    Player existing;
+    if (!fresh && load(player.name(), existing)) { continue; }
+    if (!append(player)) { return false; }
+  }
+  sync();
+  return write_index();
+}
+
+bool PlayerStore::export_text(const char *text_path) const {
+  std::wofstream file(text_path, std::ios::trunc);
+  if (!file) { return false; }
+  for_each([&file](const Player &player) { player.write_file(file); });
+  return static_cast<bool>(file);
+}
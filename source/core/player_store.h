@@ -0,0 +1,250 @@
+#ifndef PLAYER_STORE_H
+#define PLAYER_STORE_H
+/*!
+ * Player store class
+ * @file player_store.h
+ *
+ * Keeps every player in a binary file, Players.dat, that is mapped
+ * into memory and read and updated in place. Each player has a fixed
+ * size record with its counters, followed by its name and an out of
+ * line block with its played words (see WordSet::encode()), so changing
+ * a counter is a plain store into the mapping and nothing is parsed to
+ * read a player.
+ *
+ * Records are looked up by name through a sorted directory of (name
+ * hash, record offset) pairs kept in Players.idx. Players added after
+ * the directory was written sit past its `covered_end` and are found by
+ * walking that tail; the directory is rewritten once the tail grows.
+ *
+ * Data file layout (native endianness, 8-byte aligned):
+ * ```
+ *  Header
+ *  chunks, each a ChunkHeader followed by its payload:
+ *    PLAYER: Record, name (UTF-8), played words block (words_capacity bytes)
+ *    WORDS:  a played words block that outgrew the one after its record
+ * ```
+ * Space is only ever appended: a chunk is written whole before `end`
+ * is moved past it, so a crash leaves at most an unreachable chunk.
+ *
+ * The old text format (Players.txt) is imported with import_text() and
+ * written back with export_text(); the `hangman_players` tool does both.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "../utils/mapped_file.h"
+#include "player.h"
+
+class Dictionary;
+
+class PlayerStore {
+  //=== Public types
+public:
+  /// Fixed header at the start of the data file.
+  struct Header {
+    char magic[8];      //!< Always MAGIC.
+    uint32_t version;   //!< Always VERSION.
+    uint32_t reserved;
+    uint64_t file_id;   //!< Random id, matched by the index.
+    uint64_t n_players; //!< Number of PLAYER chunks.
+    uint64_t end;       //!< Bytes in use; chunks start past the header.
+  };
+
+  /// Kinds of chunks.
+  enum chunk_e : uint32_t {
+    PLAYER = 1, //!< A player record.
+    WORDS,      //!< A relocated played words block.
+  };
+
+  /// Header of every chunk.
+  struct ChunkHeader {
+    uint32_t kind; //!< A chunk_e.
+    uint32_t size; //!< Payload size, a multiple of 8.
+  };
+
+  /// Fixed part of a player.
+  struct Record {
+    uint64_t hash;           //!< FNV-1a hash of the name, in UTF-8.
+    uint64_t score;          //!< Player::score().
+    uint32_t easy;           //!< Player::easy_played().
+    uint32_t medium;         //!< Player::normal_played().
+    uint32_t hard;           //!< Player::hard_played().
+    uint32_t words;          //!< Player::n_words().
+    uint32_t wins;           //!< Player::n_wins().
+    uint32_t loses;          //!< Player::n_loses().
+    uint32_t name_size;      //!< Bytes of name after the record.
+    uint32_t words_size;     //!< Bytes used in the played words block.
+    uint32_t words_capacity; //!< Size of the played words block.
+    uint32_t reserved;
+    uint64_t words_off;      //!< Offset of the played words block in the file.
+  };
+
+  /// Header of the index file.
+  struct IndexHeader {
+    char magic[8];        //!< Always INDEX_MAGIC.
+    uint32_t version;     //!< Always VERSION.
+    uint32_t reserved;
+    uint64_t file_id;     //!< Header::file_id of the data file it indexes.
+    uint64_t n_entries;   //!< Number of players indexed.
+    uint64_t covered_end; //!< Header::end when the index was written.
+  };
+
+  /// Directory entry of one player.
+  struct Entry {
+    uint64_t hash;   //!< Record::hash.
+    uint64_t offset; //!< Offset of the Record in the data file.
+  };
+
+  static constexpr char MAGIC[8] = {'H', 'G', 'M', 'P', 'L', 'A', 'Y', '\0'};
+  static constexpr char INDEX_MAGIC[8] = {'H', 'G', 'M', 'P', 'I', 'D', 'X', '\0'};
+  static constexpr uint32_t VERSION = 2;
+  /// Players past the index before it is worth rewriting it.
+  static constexpr uint64_t INDEX_SLACK = 1024;
+
+  //=== Data members
+private:
+  std::string m_data_path;  //!< Players.dat.
+  std::string m_index_path; //!< Players.idx.
+  SharedMappedFile m_data;  //!< The data file, mapped read-write.
+  MappedFile m_index;       //!< The index, mapped.
+  std::string m_buffer;     //!< Scratch space for names and played words.
+
+  //=== Public interface
+public:
+  /**
+   * @brief Create a store over a data file.
+   *
+   * @param data_path The players file.
+   * @param index_path Its index.
+   */
+  PlayerStore(std::string data_path = "Players.dat", std::string index_path = "Players.idx");
+
+  /// Return whether the data file exists.
+  [[nodiscard]] bool exists() const;
+
+  /**
+   * @brief Map the data file, creating it if needed, and its index.
+   *
+   * A missing or foreign index is rebuilt. Call it again to see changes
+   * made through another PlayerStore.
+   *
+   * @return false if the data file could not be created or is not a
+   * players file.
+   */
+  bool open();
+
+  /// Return the number of players.
+  [[nodiscard]] size_t size() const;
+
+  /// Return the number of players added since the index was written.
+  [[nodiscard]] size_t unindexed() const;
+
+  /**
+   * @brief Read one player.
+   *
+   * @param name The player's name.
+   * @param player Receives the player, if found.
+   * @return true if the player is in the store.
+   */
+  bool load(std::wstring_view name, Player &player) const;
+
+  /**
+   * @brief Write a player: its record is updated in place, or appended
+   * if it is new.
+   *
+   * @return false if the file could not grow.
+   */
+  bool save(const Player &player);
+
+  /// Flush changes to the file.
+  void sync() { m_data.sync(); }
+
+  /// Call `fn(player)` for every player, in file order.
+  template <typename Fn> void for_each(Fn &&fn) const {
+    for_each_chunk([&](uint64_t offset, const ChunkHeader &chunk) {
+      if (chunk.kind != PLAYER || !is_record(offset)) { return; }
+      Player player;
+      read(offset, player);
+      fn(player);
+    });
+  }
+
+  /**
+   * @brief Rewrite the index so that it covers every player.
+   *
+   * The index is written to a temporary file and renamed into place.
+   */
+  bool write_index();
+
+  /**
+   * @brief Add the players of a Players.txt file to the store.
+   *
+   * Players already in the store are skipped, as are repeated names
+   * (the first record wins, as it used to).
+   *
+   * @param text_path The text file.
+   * @param dictionary Resolves played words in records older than ids.
+   * @return false if the text file could not be read.
+   */
+  bool import_text(const char *text_path, const Dictionary &dictionary);
+
+  /// Write every player in the text format, in file order.
+  bool export_text(const char *text_path) const;
+
+  /// Hash a player name, as stored in records.
+  static uint64_t hash(std::string_view utf8_name);
+
+private:
+  /**
+   * @brief Call `fn(offset, chunk)` with the payload offset of every chunk
+   * past `from`; stops at a chunk that does not fit in the file.
+   */
+  template <typename Fn> void for_each_chunk(Fn &&fn, uint64_t from = 0) const {
+    const Header *header = this->header();
+    if (header == nullptr) { return; }
+    uint64_t end = std::min<uint64_t>(header->end, m_data.size());
+    for (uint64_t pos = from != 0 ? from : sizeof(Header); pos + sizeof(ChunkHeader) <= end;) {
+      ChunkHeader chunk = *reinterpret_cast<const ChunkHeader *>(m_data.data() + pos);
+      if (chunk.size % 8 != 0 || chunk.size > end - pos - sizeof(ChunkHeader)) { return; }
+      fn(pos + sizeof(ChunkHeader), chunk);
+      pos += sizeof(ChunkHeader) + chunk.size;
+    }
+  }
+
+  /**
+   * @brief Return whether `offset` is the payload of a PLAYER chunk that
+   * holds its record and name, and whose played words block lies within
+   * the file's `end`.
+   */
+  [[nodiscard]] bool is_record(uint64_t offset) const;
+
+  /// Return the header, or nullptr if the file is not open.
+  [[nodiscard]] const Header *header() const;
+
+  /// Return the offset of the record of the player with a UTF-8 name, or 0.
+  [[nodiscard]] uint64_t find(std::string_view utf8_name) const;
+
+  /// Fill a player from the record at `offset`.
+  void read(uint64_t offset, Player &player) const;
+
+  /**
+   * @brief Append a chunk, growing the file if needed.
+   *
+   * @return The payload offset; the chunk is not reachable until commit().
+   */
+  uint64_t allocate(chunk_e kind, size_t payload);
+
+  /// Make the chunk ending at `end` reachable.
+  void commit(uint64_t end, bool player);
+
+  /// Add a new player, without looking for it first.
+  bool append(const Player &player);
+
+  /// Copy the counters of a player into its record.
+  static void write_counters(const Player &player, Record &record);
+};
+#endif
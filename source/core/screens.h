@@ -0,0 +1,190 @@
+#ifndef SCREENS_H
+#define SCREENS_H
+/*!
+ * Screen templates
+ * @file screens.h
+ *
+ * The fixed parts of every screen, styled and joined at compile time
+ * (see Color::Text), so drawing them copies one run of characters into
+ * the frame. GALLOWS holds the whole gallows for each number of wrong
+ * guesses.
+ *
+ * Every styled run ends with a reset, so no style carries over to the
+ * next line.
+ */
+
+#include <string_view>
+
+#include "../utils/text_color.h"
+
+namespace screen {
+using Color::styled;
+using Color::text;
+
+/// A title bar.
+template <size_t N> constexpr auto title(const wchar_t (&bar)[N]) {
+  return styled<Color::BRIGHT_CYAN, Color::BOLD>(bar) + text(L"\n");
+}
+
+/// A line of the gallows with part of the hangman.
+template <size_t N> constexpr auto body(const wchar_t (&part)[N]) {
+  return text(L"    |") + styled<Color::RED, Color::BOLD>(part) + text(L"\n");
+}
+
+//=== Welcome and menus.
+inline constexpr auto WELCOME = title(L" ---> Welcome to Hangman, v 1.0 <---") +
+                                text(L"        -copyright UFRN 2024-\n"
+                                     L"\n"
+                                     L"Please, enter your name:\n");
+
+inline constexpr auto MAIN_MENU = title(L"=----------------[ MAIN MENU ]----------------=") +
+                                  text(L"Please choose an option:\n"
+                                       L"1 - Start a new challenge.\n"
+                                       L"2 - Show the game rules.\n"
+                                       L"3 - Show scoreboard.\n"
+                                       L"4 - Change difucult of the game.\n"
+                                       L"5 - Choose the category of the words.\n"
+                                       L"6 - Quit the game.\n"
+                                       L"\n"
+                                       L"Press your option number.\n"
+                                       L"=---------------------------------------------=\n");
+
+inline constexpr auto QUITTING = title(L"=----------------[ QUITTING ]----------------=") +
+                                 text(L"Are you sure you want to quit?\n"
+                                      L"\n"
+                                      L"Type YES/NO and press 'enter'.\n"
+                                      L"=--------------------------------------------=\n");
+
+/// Followed by the player's name, then RULES.
+inline constexpr auto RULES_TITLE =
+    title(L"=--------------------------[ Gameplay ]----------------------------=") + text(L"Hi ");
+
+inline constexpr auto RULES = text(
+    L" , here are the game rules:\n"
+    L"[1] You need to guess the secret word or phrase the game has chosen\n"
+    L"    by suggesting letters.\n"
+    L"[2] We will display a row of dashes, representing each letter of the\n"
+    L"    the secret word/phrase you're trying to guess.\n"
+    L"[3] Each correct guess earns you 1 point.\n"
+    L"[4] Each wrong guess you loose 1 point and I draw on component of a\n"
+    L"hanged stick figure (the hangman!)\n"
+    L"[5] If you wrong guess 6 times you loose the challenge\n"
+    L"[6] If you can guess the secret word/phrase before the hangman is\n"
+    L"    complete you add 2 extra points to your overall score.\n"
+    L"[7] After a guessing round (challenge) is complete you may try another\n"
+    L"    secret word/phrase or quit the game.\n"
+    L"\n"
+    L"Press 'Enter' to continue\n"
+    L"=------------------------------------------------------------------=\n");
+
+inline constexpr auto ENDGAME = title(L"=----------------[ Farewell ]------------------=") +
+                                text(L"\n"
+                                     L"Thank you for play hangman!\n"
+                                     L"\n"
+                                     L"=----------------------------------------------=\n");
+
+inline constexpr auto DIFICULT =
+    title(L"=-------------------------------[ DIFICULT ]-------------------------------=") +
+    text(L"1 - Easy: The game starts with some letters revealed and words have few,\n"
+         L"    common letters.\n"
+         L"2 - Medium: Words of average difficulty are chosen and no letters are\n"
+         L"    revealed.\n"
+         L"3 - Hard: Words with greater diversity of letters, and rarer ones.\n"
+         L"\n"
+         L"On easy difficulty the score achieved is divided in half.\n"
+         L"On medium difficulty the score will be normal.\n"
+         L"On hard difficulty the score achieved is doubled, but you lose more points\n"
+         L"if you lose.\n"
+         L"\n"
+         L"Press your option number.\n"
+         L"=--------------------------------------------------------------------------=\n");
+
+/// Followed by the categories, then CATEGORY_FOOTER.
+inline constexpr auto CATEGORY_TITLE =
+    title(L"=----------------[ CATEGORY ]----------------=") + text(L"0 - Any category.\n");
+
+inline constexpr auto CATEGORY_FOOTER = text(L"\n"
+                                             L"Enter your option number and hit 'Enter'.\n"
+                                             L"=--------------------------------------------=\n");
+
+inline constexpr auto NO_WORDS =
+    title(L"=--------------------------------------------------------------------------=") +
+    text(L"\n"
+         L"There are no words to play in this dificult and category.\n"
+         L"Please change the dificult, the category or clean the list of played words.\n"
+         L"\n"
+         L"\n"
+         L"If you want to clear the words, type 'Yes', if not, type 'No'.\n"
+         L"And press 'ENTER' to continue\n"
+         L"\n"
+         L"=--------------------------------------------------------------------------=\n");
+
+//=== Scoreboard.
+/// Followed by the order and page.
+inline constexpr auto SCOREBOARD_TITLE =
+    title(L"=------------------------------[ SCOREBOARD ]------------------------------=") +
+    text(L"\n"
+         L"Ranked by ");
+
+/// Followed by the players.
+inline constexpr auto SCOREBOARD_HEADER = text(
+    L"\n"
+    L"#    Player              Score     Easy    Normal  Hard    Words   Win/Lose\n"
+    L"\n");
+
+inline constexpr auto SCOREBOARD_FOOTER = text(
+    L"\n"
+    L"Rank by: 1 - score, 2 - hard games, 3 - win rate, 4 - words played.\n"
+    L"Press 'n' for the next page, 'p' for the previous one, or just 'Enter' to\n"
+    L"continue.\n"
+    L"\n"
+    L"=--------------------------------------------------------------------------=\n");
+
+//=== Play screen.
+/// Followed by the categories.
+inline constexpr auto PLAY_TITLE =
+    title(L"=---------------------[ HANGMAN ]---------------------=") + text(L"Categories: ");
+
+inline constexpr auto GALLOWS_TOP = text(L"    _________________\n"
+                                         L"    |               |\n"
+                                         L"    |               |\n");
+inline constexpr auto GALLOWS_BASE = text(L"    |\n"
+                                          L"    |\n"
+                                          L"    |\n"
+                                          L"____|____\n");
+inline constexpr auto POLE = text(L"    |\n");
+inline constexpr auto HEAD = body(L"               O");
+inline constexpr auto NECK = body(L"               |");
+inline constexpr auto ARM_1 = body(L"              /|");
+inline constexpr auto ARM_2 = body(L"             / |");
+inline constexpr auto ARMS_1 = body(L"              /|\\");
+inline constexpr auto ARMS_2 = body(L"             / | \\");
+inline constexpr auto LEG_1 = body(L"              /");
+inline constexpr auto LEG_2 = body(L"             /");
+inline constexpr auto LEGS_1 = body(L"              / \\");
+inline constexpr auto LEGS_2 = body(L"             /   \\");
+
+inline constexpr auto GALLOWS_0 = GALLOWS_TOP + POLE + POLE + POLE + POLE + POLE + GALLOWS_BASE;
+inline constexpr auto GALLOWS_1 = GALLOWS_TOP + HEAD + POLE + POLE + POLE + POLE + GALLOWS_BASE;
+inline constexpr auto GALLOWS_2 = GALLOWS_TOP + HEAD + NECK + NECK + POLE + POLE + GALLOWS_BASE;
+inline constexpr auto GALLOWS_3 = GALLOWS_TOP + HEAD + ARM_1 + ARM_2 + POLE + POLE + GALLOWS_BASE;
+inline constexpr auto GALLOWS_4 = GALLOWS_TOP + HEAD + ARMS_1 + ARMS_2 + POLE + POLE + GALLOWS_BASE;
+inline constexpr auto GALLOWS_5 = GALLOWS_TOP + HEAD + ARMS_1 + ARMS_2 + LEG_1 + LEG_2 + GALLOWS_BASE;
+inline constexpr auto GALLOWS_6 = GALLOWS_TOP + HEAD + ARMS_1 + ARMS_2 + LEGS_1 + LEGS_2 + GALLOWS_BASE;
+
+/// The gallows, by number of wrong guesses.
+inline constexpr std::wstring_view GALLOWS[] = {GALLOWS_0.view(), GALLOWS_1.view(), GALLOWS_2.view(),
+                                                GALLOWS_3.view(), GALLOWS_4.view(), GALLOWS_5.view(),
+                                                GALLOWS_6.view()};
+
+inline constexpr auto DIGIT = styled<Color::YELLOW>(L"This is a digit, try again.") + text(L"\n\n");
+inline constexpr auto REPEATED =
+    styled<Color::YELLOW>(L"This letter has already been used, try again.") + text(L"\n\n");
+inline constexpr auto LOST = styled<Color::RED, Color::BOLD>(L"You lose, press Enter to continue") + text(L"\n");
+inline constexpr auto WON = styled<Color::GREEN, Color::BOLD>(L"You win, press Enter to continue") + text(L"\n");
+inline constexpr auto PROMPT = text(L"Press '&' if you want to guess the entire word, then type it and press\n"
+                                    L"'Enter'.\n"
+                                    L"Press '#' if you want to quit.\n"
+                                    L"Press a letter to guess it:\n");
+} // namespace screen
+#endif
@@ -0,0 +1,249 @@
+/*!
+ * Session class implementation.
+ *
+ * \file session.cpp
+ */
+
+#include <algorithm>
+#include <cwctype>
+#include <utility>
+
+#include "session.h"
+
+/// Upper case a character.
+static wchar_t to_upper(wchar_t c) { return static_cast<wchar_t>(std::towupper(static_cast<wint_t>(c))); }
+
+Session::Session(const SharedDictionary &words, const Leaderboard &leaderboard, Player player, uint64_t seed)
+    : m_words{words},
+      m_generation{words.generation()},
+      m_dictionary{words.current()},
+      m_leaderboard{leaderboard},
+      m_player{std::move(player)},
+      m_rng{seed} {
+  // A match makes at most a few changes; they are flushed after each input.
+  m_changes.reserve(8);
+  // Run up to the main menu, where the first key is awaited.
+  m_flow = flow();
+  m_flow.start();
+}
+
+bool Session::handle(const Input &input) {
+  if (m_flow.done()) { return false; }
+  m_input = &input;
+  m_valid = true;
+  m_waiting.resume();
+  m_input = nullptr;
+  return m_valid;
+}
+
+void Session::forfeit() {
+  if (!m_played || m_match.status() != Match::status_e::ON) { return; }
+  m_match.leave(m_player);
+  m_changes.push_back({Change::event_e::MATCH_ENDED});
+}
+
+Session::View Session::view() const {
+  return {m_screen,   &m_player,  m_played ? &m_match : nullptr, m_notice, m_dificult,
+          m_category, m_board_order, m_board_first};
+}
+
+Flow<> Session::flow() {
+  static constexpr Binding<wchar_t, menu_e> MENU_KEYS[] = {
+      {L'1', menu_e::PLAY},     {L'2', menu_e::RULES},    {L'3', menu_e::SCORE},
+      {L'4', menu_e::DIFICULT}, {L'5', menu_e::CATEGORY}, {L'6', menu_e::EXIT}};
+  static constexpr Binding<wchar_t, Match::dificult_e> DIFICULT_KEYS[] = {
+      {L'1', Match::dificult_e::EASY}, {L'2', Match::dificult_e::NORMAL}, {L'3', Match::dificult_e::HARD}};
+  while (true) {
+    m_screen = screen_e::MAIN_MENU;
+    const menu_e *option;
+    while ((option = lookup(MENU_KEYS, to_upper(co_await next_key()))) == nullptr) { reject(); }
+    switch (*option) {
+    case menu_e::PLAY:
+      co_await play();
+      break;
+    case menu_e::RULES:
+      // Any key goes back.
+      m_screen = screen_e::RULES;
+      co_await next_key();
+      break;
+    case menu_e::SCORE:
+      co_await scoreboard();
+      break;
+    case menu_e::EXIT:
+      m_screen = screen_e::QUITTING;
+      if (co_await confirm()) {
+        m_screen = screen_e::ENDED;
+        co_return;
+      }
+      break;
+    case menu_e::DIFICULT: {
+      m_screen = screen_e::DIFICULT;
+      const Match::dificult_e *dificult;
+      while ((dificult = lookup(DIFICULT_KEYS, to_upper(co_await next_key()))) == nullptr) { reject(); }
+      m_dificult = *dificult;
+      break;
+    }
+    case menu_e::CATEGORY:
+      m_screen = screen_e::CATEGORY;
+      while (!parse_category(co_await next_line(), m_category)) { reject(); }
+      break;
+    }
+  }
+}
+
+Flow<> Session::play() {
+  // The match keeps these words until it ends, even if they are reloaded.
+  refresh_words();
+  uint32_t id;
+  if (!choose_word(id)) {
+    // Offer to clear the played words.
+    m_screen = screen_e::NO_WORDS;
+    if (co_await confirm()) {
+      m_player.clear_word_list();
+      m_pickers.clear();
+      m_changes.push_back({Change::event_e::WORDS_CLEARED});
+    }
+    co_return;
+  }
+  m_match.start(m_dictionary->word(id), id, m_dificult);
+  m_played = true;
+  m_notice = notice_e::NONE;
+  m_player.add_word(id);
+  m_changes.push_back({Change::event_e::MATCH_STARTED, id});
+  m_screen = screen_e::PLAYING;
+  while (m_match.status() == Match::status_e::ON) {
+    wchar_t key = to_upper(co_await next_key());
+    if (key == L'\n' || std::iswspace(static_cast<wint_t>(key))) { continue; }
+    m_notice = notice_e::NONE;
+    if (key == L'#') {
+      // Leaving a match loses it; its result is shown next.
+      m_screen = screen_e::QUITTING;
+      if (co_await confirm()) { m_match.leave(m_player); }
+      m_screen = screen_e::PLAYING;
+    } else if (key == L'&') {
+      m_match.guess_word(upper(co_await next_line()), m_player);
+    } else {
+      switch (m_match.guess(key, m_player)) {
+      case Match::guess_e::DIGIT:
+        m_notice = notice_e::DIGIT;
+        break;
+      case Match::guess_e::REPEATED:
+        m_notice = notice_e::REPEATED;
+        break;
+      default:
+        break;
+      }
+    }
+  }
+  m_changes.push_back({Change::event_e::MATCH_ENDED});
+  // The result is on screen; any key goes back to the menu.
+  co_await next_key();
+}
+
+Flow<> Session::scoreboard() {
+  static_assert(Leaderboard::N_ORDERS == 4, "a key to rank by each order");
+  static constexpr Binding<wchar_t, board_e> KEYS[] = {
+      {L'\n', board_e::LEAVE},   {L'N', board_e::NEXT},    {L'P', board_e::PREVIOUS},
+      {L'1', board_e::BY_SCORE}, {L'2', board_e::BY_HARD}, {L'3', board_e::BY_WIN_RATE},
+      {L'4', board_e::BY_WORDS}};
+  m_screen = screen_e::SCOREBOARD;
+  m_board_order = Leaderboard::order_e::SCORE;
+  m_board_first = 0;
+  while (true) {
+    const board_e *command;
+    while ((command = lookup(KEYS, to_upper(co_await next_key()))) == nullptr) { reject(); }
+    // Every page is read straight from the leaderboard, so turning pages
+    // and switching orders costs no sorting.
+    switch (*command) {
+    case board_e::LEAVE:
+      co_return;
+    case board_e::NEXT:
+      if (m_board_first + BOARD_PAGE < m_leaderboard.size()) { m_board_first += BOARD_PAGE; }
+      break;
+    case board_e::PREVIOUS:
+      m_board_first -= std::min(m_board_first, BOARD_PAGE);
+      break;
+    default:
+      m_board_order = static_cast<Leaderboard::order_e>(static_cast<short>(*command) -
+                                                        static_cast<short>(board_e::BY_SCORE));
+      m_board_first = 0;
+      break;
+    }
+  }
+}
+
+Flow<bool> Session::confirm() {
+  const bool *yes;
+  while ((yes = yes_or_no(co_await next_line())) == nullptr) { reject(); }
+  co_return *yes;
+}
+
+bool Session::parse_category(std::wstring_view line, uint32_t &category) const {
+  // Digits only, and no more than there are categories.
+  size_t n = 0;
+  bool valid = !line.empty();
+  for (wchar_t c : line) {
+    valid = valid && std::iswdigit(static_cast<wint_t>(c)) && n <= m_dictionary->n_categories();
+    if (valid) { n = n * 10 + static_cast<size_t>(c - L'0'); }
+  }
+  if (!valid || n > m_dictionary->n_categories()) { return false; }
+  category = n == 0 ? Dictionary::NO_CATEGORY : static_cast<uint32_t>(n - 1);
+  return true;
+}
+
+void Session::refresh_words() {
+  // Only a reload takes the snapshot again.
+  uint64_t generation = m_words.generation();
+  if (generation == m_generation) { return; }
+  m_generation = generation;
+  m_dictionary = m_words.current();
+  // The pickers point into the old words; a category may be gone.
+  m_pickers.clear();
+  if (m_category != Dictionary::NO_CATEGORY && m_category >= m_dictionary->n_categories()) {
+    m_category = Dictionary::NO_CATEGORY;
+  }
+}
+
+template <typename K, typename T, size_t N>
+const T *Session::lookup(const Binding<K, T> (&table)[N], K input) {
+  for (const auto &binding : table) {
+    if (binding.input == input) { return &binding.value; }
+  }
+  return nullptr;
+}
+
+std::wstring_view Session::upper(std::wstring_view line) {
+  m_line.assign(line);
+  for (wchar_t &c : m_line) { c = to_upper(c); }
+  return m_line;
+}
+
+const bool *Session::yes_or_no(std::wstring_view line) {
+  static constexpr Binding<std::wstring_view, bool> WORDS[] = {{L"YES", true}, {L"NO", false}};
+  return lookup(WORDS, upper(line));
+}
+
+bool Session::choose_word(uint32_t &id) {
+  Dictionary::tier_e tier = Dictionary::NORMAL;
+  switch (m_dificult) {
+  case Match::dificult_e::EASY:
+    tier = Dictionary::EASY;
+    break;
+  case Match::dificult_e::NORMAL:
+    tier = Dictionary::NORMAL;
+    break;
+  case Match::dificult_e::HARD:
+    tier = Dictionary::HARD;
+    break;
+  }
+  // One picker per (category, tier), living as long as the session.
+  uint64_t key = (static_cast<uint64_t>(m_category) << 32) | tier;
+  auto it = m_pickers.find(key);
+  if (it == m_pickers.end()) {
+    it = m_pickers.emplace(key, WordPicker(m_dictionary->words_in(m_category, tier))).first;
+  }
+  while (it->second.next(m_rng, id)) {
+    if (!m_player.has_played(id)) { return true; }
+  }
+  return false;
+}
@@ -0,0 +1,295 @@
+#ifndef SESSION_H
+#define SESSION_H
+/*!
+ * Session class
+ * @file session.h
+ *
+ * Everything a logged in player does, from the main menu to the end:
+ * menus, dificult and category choice, matches, the scoreboard pages
+ * and the quit confirmation. A Session is fed with input events; it
+ * reads no input, draws nothing and touches no file.
+ *
+ * ```c++
+ *  Session session(words, leaderboard, std::move(player), seed);
+ *  while (session.screen() != Session::screen_e::ENDED) {
+ *    draw(session.view());
+ *    Session::Input input = session.expects() == Session::input_e::KEY ? read_key() : read_line();
+ *    if (!session.handle(input)) { complain(); }
+ *    session.flush_changes([&](const Session::Change &change) { save(session.player(), change); });
+ *  }
+ * ```
+ *
+ * The host supplies the player (loaded as it likes), draws view(), and
+ * saves the changes the session reports. Keys are decoded into
+ * commands through constant tables; invalid input is rejected without
+ * recursion or allocation, and a guess allocates nothing.
+ *
+ * Inside, the session is a coroutine (see flow.h) that reads like the
+ * game: the menu loop awaits a key, plays a match, which awaits keys
+ * until it is decided, shows the scoreboard, and so on. handle() resumes
+ * it with the input, and it runs up to where it awaits the next one. An
+ * idle session is the Session object and its suspended coroutine frames,
+ * about a kilobyte and a half in all, so one thread can hold many.
+ */
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "../utils/flow.h"
+#include "../utils/splitmix64.h"
+#include "dictionary.h"
+#include "leaderboard.h"
+#include "match.h"
+#include "player.h"
+#include "shared_dictionary.h"
+#include "word_picker.h"
+
+class Session {
+  //=== Public types
+public:
+  /// What the player is looking at.
+  enum class screen_e : short {
+    MAIN_MENU = 0, //!< The main menu.
+    RULES,         //!< The game rules.
+    SCOREBOARD,    //!< A page of the scoreboard.
+    QUITTING,      //!< Confirming a quit, from the menu or from a match.
+    DIFICULT,      //!< Dificult selection.
+    CATEGORY,      //!< Category selection.
+    PLAYING,       //!< A match, or its result.
+    NO_WORDS,      //!< No words left to play; offers to clear the played words.
+    ENDED,         //!< The player quit.
+  };
+
+  /// The kind of input a screen reads.
+  enum class input_e : short {
+    KEY = 0, //!< A single key.
+    LINE,    //!< A line: a word, a number or YES/NO.
+  };
+
+  /// A key or a line typed by the player.
+  struct Input {
+    wchar_t key = 0;        //!< The key, as typed; '\n' for Enter.
+    std::wstring_view line; //!< The line, without its end, when a line is expected.
+  };
+
+  /// Why the last key did not count as a guess.
+  enum class notice_e : short {
+    NONE = 0, //!< It did, or no key was pressed yet.
+    DIGIT,    //!< It was a digit.
+    REPEATED, //!< The letter was guessed before.
+  };
+
+  /// A change made to the player, for the host to save.
+  struct Change {
+    /// What changed.
+    enum class event_e : short {
+      MATCH_STARTED = 0, //!< A word was drawn, and added to the played words.
+      MATCH_ENDED,       //!< A match was won or lost.
+      WORDS_CLEARED,     //!< The played words were cleared.
+    } event;
+    uint32_t word = Dictionary::NO_WORD; //!< The word drawn, for MATCH_STARTED.
+  };
+
+  /// What the host needs to draw the current screen.
+  struct View {
+    screen_e screen;                  //!< What to show.
+    const Player *player;             //!< The logged in player.
+    const Match *match;               //!< The match on, or the last one; nullptr before the first.
+    notice_e notice;                  //!< Why the last key was not a guess, while playing.
+    Match::dificult_e dificult;       //!< Dificult of the next match.
+    uint32_t category;                //!< Category of the next match, or Dictionary::NO_CATEGORY.
+    Leaderboard::order_e board_order; //!< Order the scoreboard is shown in.
+    size_t board_first;               //!< Position of the first player on the page, from 0.
+  };
+
+  /// Players per scoreboard page.
+  static constexpr size_t BOARD_PAGE = 10;
+
+  //=== Private types
+private:
+  /// The scoreboard commands.
+  enum class board_e : short {
+    LEAVE = 0,   //!< Back to the main menu.
+    NEXT,        //!< Next page.
+    PREVIOUS,    //!< Previous page.
+    BY_SCORE,    //!< Rank by score; this and the next follow Leaderboard::order_e.
+    BY_HARD,     //!< Rank by games played on hard.
+    BY_WIN_RATE, //!< Rank by win rate.
+    BY_WORDS,    //!< Rank by words played.
+  };
+
+  /// The menu options.
+  enum class menu_e : short {
+    PLAY = 1, //!< Begin new game.
+    RULES,    //!< Show rules of the game.
+    SCORE,    //!< Show top scores.
+    EXIT,     //!< Exit the game.
+    DIFICULT, //!< Difucult selection.
+    CATEGORY, //!< Category selection.
+  };
+
+  /// An input, and the command it stands for, in the input decoding tables.
+  template <typename K, typename T> struct Binding {
+    K input; //!< The key or word, upper cased.
+    T value; //!< The command.
+  };
+
+  /// Awaited by the flow for the next input: a key or a line, as KIND says.
+  template <input_e KIND> struct NextInput {
+    Session &session; //!< The session awaiting it.
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> flow) noexcept {
+      session.m_waiting = flow;
+      session.m_expects = KIND;
+    }
+    auto await_resume() const noexcept {
+      if constexpr (KIND == input_e::KEY) {
+        return session.m_input->key;
+      } else {
+        return session.m_input->line;
+      }
+    }
+  };
+
+  //=== Data members
+  const SharedDictionary &m_words;                                  //!< All words, as they are now.
+  uint64_t m_generation;                                            //!< Generation of m_words that m_dictionary is.
+  SharedDictionary::Snapshot m_dictionary;                          //!< The words of the match on, or the last one.
+  const Leaderboard &m_leaderboard;                                 //!< Players ranked, kept up to date by the host.
+  Player m_player;                                                  //!< The logged in player.
+  Match m_match;                                                    //!< The match on, or the last one.
+  bool m_played = false;                                            //!< Whether a match was started yet.
+  screen_e m_screen = screen_e::MAIN_MENU;                          //!< Current screen.
+  input_e m_expects = input_e::KEY;                                 //!< What the flow awaits.
+  const Input *m_input = nullptr;                                   //!< The input being handled.
+  bool m_valid = true;                                              //!< Whether the input being handled was valid.
+  std::coroutine_handle<> m_waiting;                                //!< The flow awaiting the next input.
+  notice_e m_notice = notice_e::NONE;                               //!< Why the last key was not a guess.
+  Match::dificult_e m_dificult = Match::dificult_e::NORMAL;         //!< Dificult of the next match.
+  uint32_t m_category = Dictionary::NO_CATEGORY;                    //!< Category of the next match, if any.
+  Leaderboard::order_e m_board_order = Leaderboard::order_e::SCORE; //!< Order the scoreboard is shown in.
+  size_t m_board_first = 0;                                         //!< Position of the first player on the page.
+  std::wstring m_line;                                              //!< The latest line, upper cased.
+  std::vector<Change> m_changes;                                    //!< Changes not flushed yet.
+  std::unordered_map<uint64_t, WordPicker> m_pickers;               //!< Unplayed words left, per (category, dificult).
+  SplitMix64 m_rng;                                                 //!< Random generator for drawing words.
+  Flow<> m_flow;                                                    //!< The whole session; see flow().
+
+  //=== Public interface
+public:
+  /**
+   * @brief Start a session for a player, at the main menu.
+   *
+   * @param words The words; must outlive the session. Each match plays
+   * with the words as they are when it starts.
+   * @param leaderboard The players ranked, for the scoreboard; must outlive the session.
+   * @param player The player, as loaded by the host.
+   * @param seed Seed for drawing words.
+   */
+  Session(const SharedDictionary &words, const Leaderboard &leaderboard, Player player, uint64_t seed);
+  Session(const Session &) = delete;
+  Session &operator=(const Session &) = delete;
+
+  /// Return the current screen.
+  [[nodiscard]] screen_e screen() const { return m_screen; }
+
+  /// Return the kind of input the current screen reads.
+  [[nodiscard]] input_e expects() const { return m_expects; }
+
+  /**
+   * @brief Handle a key or a line, as expects() asks.
+   *
+   * @param input What the player typed.
+   * @return false if it is not valid on this screen; nothing changed then.
+   */
+  bool handle(const Input &input);
+
+  /// Return what the host needs to draw the current screen.
+  [[nodiscard]] View view() const;
+
+  /// Return the logged in player.
+  [[nodiscard]] const Player &player() const { return m_player; }
+
+  /// Return the match on, or the last one.
+  [[nodiscard]] const Match &match() const { return m_match; }
+
+  /**
+   * @brief Give up the match on, if any, as leaving it with '#' does: it
+   * is lost, and reported as a MATCH_ENDED change.
+   *
+   * For a host dropping the session (the player disconnected, say); the
+   * session is not to be handled any further.
+   */
+  void forfeit();
+
+  /// Return the words the session plays with: those of the match on, or the last one.
+  [[nodiscard]] const Dictionary &dictionary() const { return *m_dictionary; }
+
+  /**
+   * @brief Hand the changes made to the player since the last call to `fn`,
+   * oldest first, then forget them.
+   *
+   * @param fn Called as fn(const Change &); player() is already up to date.
+   */
+  template <typename Fn> void flush_changes(Fn &&fn) {
+    for (const Change &change : m_changes) { fn(change); }
+    m_changes.clear();
+  }
+
+private:
+  //=== The flow of the session, from the main menu on.
+  Flow<> flow();
+  Flow<> play();
+  Flow<> scoreboard();
+  Flow<bool> confirm();
+
+  /// Await the next key, on a screen that reads keys.
+  NextInput<input_e::KEY> next_key() { return {*this}; }
+
+  /// Await the next line, on a screen that reads lines.
+  NextInput<input_e::LINE> next_line() { return {*this}; }
+
+  /// Mark the input being handled as not valid; the flow then awaits another.
+  void reject() { m_valid = false; }
+
+  /**
+   * @brief Read the category a line names: its number, from 1, or 0 for all.
+   *
+   * @param category Receives its index, or Dictionary::NO_CATEGORY for all.
+   * @return false if the line names none.
+   */
+  bool parse_category(std::wstring_view line, uint32_t &category) const;
+
+  /**
+   * @brief Look a key or word up in a decoding table.
+   *
+   * @return The entry found, or nullptr.
+   */
+  template <typename K, typename T, size_t N>
+  static const T *lookup(const Binding<K, T> (&table)[N], K input);
+
+  /// Play with the latest words from now on, if they changed.
+  void refresh_words();
+
+  /// Return `line` upper cased, in m_line.
+  std::wstring_view upper(std::wstring_view line);
+
+  /// Return whether `line` is YES (true) or NO (false), or nullptr if neither.
+  const bool *yes_or_no(std::wstring_view line);
+
+  /**
+   * @brief Draw a word the player has not played, for the dificult and category.
+   *
+   * @param id Receives its dictionary id.
+   * @return false if none is left.
+   */
+  bool choose_word(uint32_t &id);
+};
+
+#endif
@@ -0,0 +1,124 @@
+/*!
+ * SharedDictionary class implementation.
+ *
+ * \file shared_dictionary.cpp
+ */
+
+#include <cerrno>
+#include <cstdint>
+#include <filesystem>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <utility>
+
+#include "shared_dictionary.h"
+
+SharedDictionary::~SharedDictionary() {
+  if (m_reloader.joinable()) {
+    m_stopping.store(true);
+    request_reload();
+    m_reloader.join();
+  }
+  if (m_wake >= 0) { ::close(m_wake); }
+}
+
+bool SharedDictionary::load(std::string words_path) {
+  m_words_path = std::move(words_path);
+  m_compiled_path = std::filesystem::path(m_words_path).replace_extension(".hgd").string();
+  Dictionary dictionary;
+  if (!read(dictionary)) { return false; }
+  publish(std::move(dictionary));
+  return true;
+}
+
+void SharedDictionary::publish(Dictionary dictionary) {
+  m_current.store(std::make_shared<const Dictionary>(std::move(dictionary)), std::memory_order_release);
+  m_generation.fetch_add(1, std::memory_order_release);
+}
+
+bool SharedDictionary::read(Dictionary &dictionary) const {
+  return dictionary.open(m_compiled_path.c_str(), m_words_path.c_str()) || dictionary.build(m_words_path.c_str());
+}
+
+bool SharedDictionary::watch(ReloadFn on_reload) {
+  if (m_reloader.joinable()) { return true; }
+  m_on_reload = std::move(on_reload);
+  m_wake = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  if (m_wake < 0) { return false; }
+  // The directory is watched, not the file: editors and hangman_dictc
+  // replace files by renaming new ones over them.
+  std::filesystem::path directory = std::filesystem::path(m_words_path).parent_path();
+  int inotify = ::inotify_init1(IN_CLOEXEC | IN_NONBLOCK);
+  if (inotify >= 0 &&
+      ::inotify_add_watch(inotify, directory.empty() ? "." : directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+    ::close(inotify);
+    inotify = -1;
+  }
+  // Without inotify, reloads are still made on request.
+  m_reloader = std::thread([this, inotify] { run_reloader(inotify); });
+  return true;
+}
+
+void SharedDictionary::request_reload() const {
+  if (m_wake < 0) { return; }
+  uint64_t one = 1;
+  ssize_t written = ::write(m_wake, &one, sizeof(one));
+  (void)written;
+}
+
+void SharedDictionary::run_reloader(int inotify) {
+  std::string words = std::filesystem::path(m_words_path).filename().string();
+  std::string compiled = std::filesystem::path(m_compiled_path).filename().string();
+  pollfd fds[2] = {{m_wake, POLLIN, 0}, {inotify, POLLIN, 0}};
+  alignas(inotify_event) char events[4096];
+  bool pending = false;
+  while (!m_stopping.load()) {
+    // A change is reloaded once the file has been quiet for a while, so a
+    // file written in several steps is read whole, and only once.
+    int n = ::poll(fds, inotify >= 0 ? 2 : 1, pending ? SETTLE_MS : -1);
+    if (n < 0 && errno != EINTR) { break; }
+    if (n == 0) {
+      pending = false;
+      reload();
+      continue;
+    }
+    if ((fds[0].revents & POLLIN) != 0) {
+      uint64_t requests;
+      ssize_t got = ::read(m_wake, &requests, sizeof(requests));
+      pending = pending || got > 0;
+    }
+    if (inotify >= 0 && (fds[1].revents & POLLIN) != 0) {
+      ssize_t size;
+      while ((size = ::read(inotify, events, sizeof(events))) > 0) {
+        for (char *p = events; p < events + size;) {
+          const auto *event = reinterpret_cast<const inotify_event *>(p);
+          if (event->len > 0 && (words == event->name || compiled == event->name)) { pending = true; }
+          p += sizeof(inotify_event) + event->len;
+        }
+      }
+    }
+  }
+  if (inotify >= 0) { ::close(inotify); }
+}
+
+void SharedDictionary::reload() {
+  Dictionary dictionary;
+  Snapshot snapshot = current();
+  if (!read(dictionary) || (snapshot && !appends(*snapshot, dictionary))) {
+    // Keep playing with the words loaded.
+    if (m_on_reload) { m_on_reload(nullptr); }
+    return;
+  }
+  publish(std::move(dictionary));
+  if (m_on_reload) { m_on_reload(current().get()); }
+}
+
+bool SharedDictionary::appends(const Dictionary &current, const Dictionary &next) {
+  if (next.size() < current.size()) { return false; }
+  for (uint32_t id = 0; id < current.size(); ++id) {
+    if (current.word(id) != next.word(id)) { return false; }
+  }
+  return true;
+}
@@ -0,0 +1,120 @@
+#ifndef SHARED_DICTIONARY_H
+#define SHARED_DICTIONARY_H
+/*!
+ * SharedDictionary class
+ * @file shared_dictionary.h
+ *
+ * The words every session of a process plays with: one immutable,
+ * reference counted Dictionary snapshot, replaced whole when the words
+ * file changes, without a restart.
+ *
+ * ```c++
+ *  SharedDictionary words;
+ *  words.load("words.csv");
+ *  words.watch();                    // Reload in the background on change.
+ *  SharedDictionary::Snapshot snapshot = words.current();
+ *  snapshot->word(id);               // Stays valid, and unchanged, while held.
+ * ```
+ *
+ * Readers read a snapshot freely while they hold it. Taking one is an
+ * atomic load of a shared_ptr, which libstdc++ implements with a lock
+ * of its own, so a reader that keeps its snapshot checks generation()
+ * first, a plain lock-free load, and takes the current snapshot again
+ * only when it changed: once per reload. A Session does so as each
+ * match starts, so a match in progress keeps its words until it ends.
+ * The reloader
+ * thread builds the next snapshot on the side, when the words file (or
+ * its compiled dictionary) is written or renamed into place, as seen
+ * by inotify, or when request_reload() is called, say from a signal
+ * handler. It then publishes the snapshot atomically; the last holder
+ * of the old one frees it.
+ *
+ * Word ids are rows of the words file (see dictionary.h), kept in the
+ * played word lists of the players; so a reload is published only if
+ * it appends words and leaves the rows read before as they were.
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "dictionary.h"
+
+class SharedDictionary {
+  //=== Public types
+public:
+  /// A snapshot of the words; immutable, and alive while anyone holds it.
+  using Snapshot = std::shared_ptr<const Dictionary>;
+  /// Called by the reloader with each new snapshot, or nullptr if the words file could not be read or did more than append words.
+  using ReloadFn = std::function<void(const Dictionary *)>;
+
+  /// Quiet time, in milliseconds, after a change to the words file before it is reloaded.
+  static constexpr int SETTLE_MS = 200;
+
+  //=== Data members
+private:
+  std::atomic<Snapshot> m_current; //!< The snapshot readers take.
+  std::atomic<uint64_t> m_generation{0}; //!< Bumped after each snapshot is published.
+  std::string m_words_path;        //!< The words file.
+  std::string m_compiled_path;     //!< Its compiled dictionary, used while it is up to date.
+  ReloadFn m_on_reload;            //!< Told of every reload.
+  int m_wake = -1;                 //!< eventfd the reloader waits on, for requests and for stopping.
+  std::atomic<bool> m_stopping{false}; //!< Asks the reloader to end.
+  std::thread m_reloader;          //!< The reloader, once watch() started it.
+
+  //=== Public interface
+public:
+  SharedDictionary() = default;
+  SharedDictionary(const SharedDictionary &) = delete;
+  SharedDictionary &operator=(const SharedDictionary &) = delete;
+  /// Stops the reloader.
+  ~SharedDictionary();
+
+  /**
+   * @brief Load the words, from the compiled dictionary next to the
+   * words file (as .hgd) if it is up to date, or from the file itself.
+   *
+   * @param words_path The words file.
+   * @return false if neither could be read; nothing is published then.
+   */
+  bool load(std::string words_path);
+
+  /// Make `dictionary` the current snapshot.
+  void publish(Dictionary dictionary);
+
+  /// Return the current snapshot; never null after a successful load() or publish().
+  [[nodiscard]] Snapshot current() const { return m_current.load(std::memory_order_acquire); }
+
+  /// Return the number of snapshots published so far; current() is at least that new.
+  [[nodiscard]] uint64_t generation() const { return m_generation.load(std::memory_order_acquire); }
+
+  /**
+   * @brief Start reloading the words in the background whenever the
+   * words file changes, or a reload is requested.
+   *
+   * @param on_reload Called, on the reloader thread, after each reload.
+   * @return false if the reloader could not be started.
+   */
+  bool watch(ReloadFn on_reload = {});
+
+  /// Ask the reloader to reload the words; async-signal-safe.
+  void request_reload() const;
+
+private:
+  /// The reloader thread.
+  void run_reloader(int inotify);
+
+  /// Build a snapshot of the words file and publish it, or keep the current one.
+  void reload();
+
+  /// Return whether `next` has every word of `current` with the same id.
+  static bool appends(const Dictionary &current, const Dictionary &next);
+
+  /// Read the words into `dictionary`, as load() does.
+  bool read(Dictionary &dictionary) const;
+};
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef WORD_PICKER_H
+#define WORD_PICKER_H
+/*!
+ * Word picker class
+ * @file word_picker.h
+ *
+ * Draws the ids of a word list in random order, without repetition,
+ * in O(1) per draw. It runs Fisher-Yates one step at a time over a
+ * *virtual* copy of the list: only the positions that have been
+ * swapped are remembered, so a picker costs memory proportional to
+ * the number of draws made, not to the size of the list.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <unordered_map>
+
+#include "dictionary.h"
+
+class WordPicker {
+  //=== Data members
+private:
+  Dictionary::IdList m_ids;                           //!< The list being drawn from.
+  size_t m_cursor = 0;                                //!< Number of ids drawn so far.
+  std::unordered_map<uint32_t, uint32_t> m_displaced; //!< Position -> id, for swapped positions.
+
+  //=== Public interface
+public:
+  /// Create a picker over a list of ids (which must outlive the picker).
+  explicit WordPicker(Dictionary::IdList ids = {}) : m_ids{ids} { /*empty*/ }
+
+  /// Return the number of ids not drawn yet.
+  [[nodiscard]] size_t remaining() const { return m_ids.size() - m_cursor; }
+
+  /**
+   * @brief Draw the next id.
+   *
+   * @param rng Random generator.
+   * @param id Receives the drawn id.
+   * @return false if every id has already been drawn.
+   */
+  template <typename Rng> bool next(Rng &rng, uint32_t &id) {
+    if (remaining() == 0) { return false; }
+    std::uniform_int_distribution<size_t> distr(m_cursor, m_ids.size() - 1);
+    auto j = static_cast<uint32_t>(distr(rng));
+    id = at(j);
+    if (j != m_cursor) { m_displaced[j] = at(static_cast<uint32_t>(m_cursor)); }
+    m_displaced.erase(static_cast<uint32_t>(m_cursor));
+    m_cursor++;
+    return true;
+  }
+
+private:
+  /// Return the id currently at position `pos` of the virtual permutation.
+  [[nodiscard]] uint32_t at(uint32_t pos) const {
+    auto it = m_displaced.find(pos);
+    return it == m_displaced.end() ? m_ids[pos] : it->second;
+  }
+};
+#endif
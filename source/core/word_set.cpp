@@ -0,0 +1,166 @@
+/*!
+ * Word set class implementation.
+ *
+ * \file word_set.cpp
+ */
+
+#include <algorithm>
+#include <string>
+
+#include "word_set.h"
+
+WordSet::Chunk *WordSet::find_chunk(uint16_t key, bool create) {
+  auto it = std::lower_bound(m_chunks.begin(), m_chunks.end(), key,
+                             [](const Chunk &c, uint16_t k) { return c.key < k; });
+  if (it != m_chunks.end() && it->key == key) { return &*it; }
+  if (!create) { return nullptr; }
+  it = m_chunks.insert(it, Chunk{});
+  it->key = key;
+  return &*it;
+}
+
+void WordSet::insert(uint32_t id) {
+  Chunk *chunk = find_chunk(static_cast<uint16_t>(id >> 16), true);
+  auto low = static_cast<uint16_t>(id & 0xFFFF);
+  if (chunk->bitmap.empty()) {
+    auto it = std::lower_bound(chunk->array.begin(), chunk->array.end(), low);
+    if (it != chunk->array.end() && *it == low) { return; }
+    if (chunk->count < ARRAY_MAX) {
+      chunk->array.insert(it, low);
+      chunk->count++;
+      m_count++;
+      return;
+    }
+    // Too dense for an array: switch to a bitmap.
+    chunk->bitmap.assign(65536 / 64, 0);
+    for (uint16_t v : chunk->array) { chunk->bitmap[v >> 6] |= uint64_t{1} << (v & 63); }
+    chunk->array.clear();
+    chunk->array.shrink_to_fit();
+  }
+  uint64_t &word = chunk->bitmap[low >> 6];
+  uint64_t bit = uint64_t{1} << (low & 63);
+  if ((word & bit) == 0) {
+    word |= bit;
+    chunk->count++;
+    m_count++;
+  }
+}
+
+bool WordSet::contains(uint32_t id) const {
+  auto key = static_cast<uint16_t>(id >> 16);
+  auto it = std::lower_bound(m_chunks.begin(), m_chunks.end(), key,
+                             [](const Chunk &c, uint16_t k) { return c.key < k; });
+  if (it == m_chunks.end() || it->key != key) { return false; }
+  auto low = static_cast<uint16_t>(id & 0xFFFF);
+  if (!it->bitmap.empty()) { return (it->bitmap[low >> 6] >> (low & 63)) & 1; }
+  return std::binary_search(it->array.begin(), it->array.end(), low);
+}
+
+void WordSet::clear() {
+  m_chunks.clear();
+  m_count = 0;
+}
+
+std::wstring WordSet::to_string() const {
+  std::wstring text;
+  bool open = false;
+  uint32_t first = 0, last = 0;
+  auto flush = [&] {
+    if (!text.empty()) { text += L','; }
+    text += std::to_wstring(first);
+    if (last != first) { text += L'-' + std::to_wstring(last); }
+  };
+  for_each([&](uint32_t id) {
+    if (open && id == last + 1) {
+      last = id;
+      return;
+    }
+    if (open) { flush(); }
+    first = last = id;
+    open = true;
+  });
+  if (open) { flush(); }
+  return text;
+}
+
+namespace {
+void put_varint(std::string &out, uint32_t value) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<char>(value | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<char>(value));
+}
+
+bool get_varint(std::string_view &data, uint32_t &value) {
+  value = 0;
+  for (int shift = 0; !data.empty() && shift < 35; shift += 7) {
+    auto byte = static_cast<unsigned char>(data.front());
+    data.remove_prefix(1);
+    value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+    if ((byte & 0x80) == 0) { return true; }
+  }
+  return false;
+}
+
+/// Parse a run of decimal digits, failing on anything else or past 32 bits.
+bool parse_id(std::wstring_view text, uint32_t &value) {
+  if (text.empty()) { return false; }
+  uint64_t n = 0;
+  for (wchar_t c : text) {
+    if (c < L'0' || c > L'9') { return false; }
+    n = n * 10 + static_cast<uint64_t>(c - L'0');
+    if (n > UINT32_MAX) { return false; }
+  }
+  value = static_cast<uint32_t>(n);
+  return true;
+}
+} // namespace
+
+void WordSet::encode(std::string &out) const {
+  bool open = false;
+  uint32_t first = 0, last = 0, end = 0; // end: one past the previous run.
+  auto flush = [&] {
+    put_varint(out, first - end);
+    put_varint(out, last - first);
+    end = last + 1;
+  };
+  for_each([&](uint32_t id) {
+    if (open && id == last + 1) {
+      last = id;
+      return;
+    }
+    if (open) { flush(); }
+    first = last = id;
+    open = true;
+  });
+  if (open) { flush(); }
+}
+
+void WordSet::decode(std::string_view data, uint32_t limit) {
+  clear();
+  uint64_t end = 0;
+  uint32_t gap, length;
+  while (end < limit && get_varint(data, gap) && get_varint(data, length)) {
+    uint64_t first = end + gap;
+    uint64_t last = std::min<uint64_t>(first + length, uint64_t{limit} - 1);
+    for (uint64_t id = first; id <= last; ++id) { insert(static_cast<uint32_t>(id)); }
+    end = first + length + 1;
+  }
+}
+
+void WordSet::from_string(std::wstring_view text, uint32_t limit) {
+  clear();
+  while (!text.empty()) {
+    size_t comma = text.find(L',');
+    std::wstring_view item = text.substr(0, comma);
+    text.remove_prefix(comma == std::wstring_view::npos ? text.size() : comma + 1);
+    size_t dash = item.find(L'-');
+    std::wstring_view a = item.substr(0, dash);
+    std::wstring_view b = dash == std::wstring_view::npos ? a : item.substr(dash + 1);
+    uint32_t first, last;
+    if (!parse_id(a, first) || !parse_id(b, last) || first >= limit) { continue; }
+    last = std::min(last, limit - 1);
+    for (uint64_t id = first; id <= last; ++id) { insert(static_cast<uint32_t>(id)); }
+  }
+}
@@ -0,0 +1,112 @@
+#ifndef WORD_SET_H
+#define WORD_SET_H
+/*!
+ * Word set class
+ * @file word_set.h
+ *
+ * Compressed set of dictionary word ids, used for the words a player
+ * has already played. Ids are split by their high 16 bits into
+ * chunks; each chunk is stored as a sorted array of its low 16 bits
+ * while it is sparse, and switches to a 65536-bit bitmap once it holds
+ * more than ARRAY_MAX ids (the same layout as a roaring bitmap). A
+ * few played words cost a few bytes, and a veteran player's history
+ * never costs more than one bit per dictionary word.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class WordSet {
+  //=== Private types
+private:
+  /// Ids sharing the same high 16 bits.
+  struct Chunk {
+    uint16_t key;                 //!< High 16 bits of the ids.
+    std::vector<uint16_t> array;  //!< Sorted low bits, while sparse.
+    std::vector<uint64_t> bitmap; //!< Low bits as a bitmap, once dense.
+    uint32_t count = 0;           //!< Number of ids in the chunk.
+  };
+
+  /// Chunks larger than this become bitmaps.
+  static constexpr uint32_t ARRAY_MAX = 4096;
+
+  //=== Data members
+  std::vector<Chunk> m_chunks; //!< Chunks, sorted by key.
+  size_t m_count = 0;          //!< Number of ids in the set.
+
+  //=== Public interface
+public:
+  /// Ids decoded or parsed are below this unless told otherwise: more words than any words file holds.
+  static constexpr uint32_t LIMIT = uint32_t{1} << 24;
+
+  /// Add an id to the set.
+  void insert(uint32_t id);
+
+  /// Check whether an id is in the set.
+  [[nodiscard]] bool contains(uint32_t id) const;
+
+  /// Return the number of ids in the set.
+  [[nodiscard]] size_t size() const { return m_count; }
+
+  /// Return whether the set is empty.
+  [[nodiscard]] bool empty() const { return m_count == 0; }
+
+  /// Remove every id.
+  void clear();
+
+  /// Call `fn(id)` for every id, in increasing order.
+  template <typename Fn> void for_each(Fn &&fn) const {
+    for (const Chunk &chunk : m_chunks) {
+      uint32_t high = static_cast<uint32_t>(chunk.key) << 16;
+      if (chunk.bitmap.empty()) {
+        for (uint16_t low : chunk.array) { fn(high | low); }
+        continue;
+      }
+      for (size_t w = 0; w < chunk.bitmap.size(); ++w) {
+        for (uint64_t bits = chunk.bitmap[w]; bits != 0; bits &= bits - 1) {
+          fn(high | static_cast<uint32_t>(w * 64 + __builtin_ctzll(bits)));
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief Encode the set as text: comma separated ids and `first-last` runs.
+   *
+   * @return e.g. "3-5,9,12".
+   */
+  [[nodiscard]] std::wstring to_string() const;
+
+  /**
+   * @brief Replace the contents with a set encoded by to_string().
+   *
+   * @param text The encoded set; malformed parts are skipped, as are
+   * numbers past 32 bits.
+   * @param limit Ids at or past it are dropped; runs are cut there.
+   */
+  void from_string(std::wstring_view text, uint32_t limit = LIMIT);
+
+  /**
+   * @brief Append the set to `out` in binary: the same runs as
+   * to_string(), as pairs of LEB128 varints (gap since the end of the
+   * previous run, run length - 1).
+   */
+  void encode(std::string &out) const;
+
+  /**
+   * @brief Replace the contents with a set encoded by encode().
+   *
+   * @param data The encoded set; decoding stops at a truncated varint.
+   * @param limit Ids at or past it are dropped; runs are cut there, so a
+   * corrupt run length cannot make decoding run away.
+   */
+  void decode(std::string_view data, uint32_t limit = LIMIT);
+
+private:
+  /// Return the chunk for `key`, creating it if `create` is set.
+  Chunk *find_chunk(uint16_t key, bool create);
+};
+#endif
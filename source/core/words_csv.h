@@ -0,0 +1,64 @@
+#ifndef WORDS_CSV_H
+#define WORDS_CSV_H
+/*!
+ * Single pass scanner for the words file.
+ * @file words_csv.h
+ *
+ * The words file is a CSV with a header line followed by one entry
+ * per line: the word itself and then one or more categories, all
+ * separated by commas. The scanner works directly on the file bytes
+ * (usually a MappedFile) and hands out `string_view`s into them, so
+ * nothing is copied until the caller decides to keep a field.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <string_view>
+
+namespace words_csv {
+/// Upper bound on the number of entries in `csv` (one per line after the header).
+inline size_t count_entries(std::string_view csv) {
+  size_t lines = std::count(csv.begin(), csv.end(), '\n');
+  if (!csv.empty() && csv.back() != '\n') { lines++; }
+  return lines > 0 ? lines - 1 : 0;
+}
+
+/// Pops the next comma separated field from `rest`.
+/*!
+ * @param rest Remaining fields of a line; shrinks past the returned field.
+ * @return The field, without the separator.
+ */
+inline std::string_view next_field(std::string_view &rest) {
+  size_t comma = rest.find(',');
+  std::string_view field = rest.substr(0, comma);
+  rest.remove_prefix(comma == std::string_view::npos ? rest.size() : comma + 1);
+  return field;
+}
+
+/// Calls `on_entry(word, categories)` for every entry in `csv`.
+/*!
+ * The header line and blank lines are skipped, and a trailing '\r' is
+ * dropped so files saved on Windows work too. `categories` holds the
+ * remaining comma separated fields; split them with next_field().
+ *
+ * @param csv The whole words file.
+ * @param on_entry Callable taking two `std::string_view`s.
+ */
+template <typename Fn> void for_each_entry(std::string_view csv, Fn &&on_entry) {
+  bool header = true;
+  while (!csv.empty()) {
+    size_t eol = csv.find('\n');
+    std::string_view line = csv.substr(0, eol);
+    csv.remove_prefix(eol == std::string_view::npos ? csv.size() : eol + 1);
+    if (!line.empty() && line.back() == '\r') { line.remove_suffix(1); }
+    if (header) {
+      header = false;
+      continue;
+    }
+    if (line.empty()) { continue; }
+    std::string_view word = next_field(line);
+    on_entry(word, line);
+  }
+}
+} // namespace words_csv
+#endif
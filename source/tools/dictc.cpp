@@ -0,0 +1,72 @@
+/*!
+ * Dictionary compiler.
+ * @file dictc.cpp
+ *
+ * Compiles the words file into the binary dictionary format read by
+ * the game (see dictionary.h), so that the game can start without
+ * parsing the csv.
+ *
+ * Usage: hangman_dictc [words.csv] [words.hgd]
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "../utils/mapped_file.h"
+#include "dictionary.h"
+
+int main(int argc, char *argv[]) {
+  const char *csv_path = argc > 1 ? argv[1] : "words.csv";
+  std::string out_path = argc > 2 ? argv[2] : "words.hgd";
+
+  MappedFile csv(csv_path);
+  uint64_t size = 0;
+  int64_t mtime = 0;
+  if (!csv.is_open() || !Dictionary::file_stamp(csv_path, size, mtime)) {
+    std::cerr << "Unable to open " << csv_path << '\n';
+    return EXIT_FAILURE;
+  }
+  std::vector<uint32_t> image = Dictionary::compile(csv.view(), size, mtime);
+
+  // Write next to the target and rename, so the game never sees half a file.
+  std::string tmp_path = out_path + ".tmp";
+  {
+    std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char *>(image.data()),
+              static_cast<std::streamsize>(image.size() * sizeof(uint32_t)));
+    if (!out) {
+      std::cerr << "Unable to write " << tmp_path << '\n';
+      return EXIT_FAILURE;
+    }
+  }
+  if (std::rename(tmp_path.c_str(), out_path.c_str()) != 0) {
+    std::cerr << "Unable to replace " << out_path << '\n';
+    std::remove(tmp_path.c_str());
+    return EXIT_FAILURE;
+  }
+
+  Dictionary dict;
+  if (!dict.open(out_path.c_str())) {
+    std::cerr << "Unable to read back " << out_path << '\n';
+    return EXIT_FAILURE;
+  }
+  std::cout << "Compiled " << dict.size() << " words and " << dict.n_categories()
+            << " categories into " << out_path << '\n';
+  static const char *tier_names[] = {"easy", "normal", "hard"};
+  for (uint32_t t = 0; t < Dictionary::N_TIERS; ++t) {
+    Dictionary::IdList ids = dict.tier(static_cast<Dictionary::tier_e>(t));
+    double distinct = 0, rarity = 0;
+    for (uint32_t id : ids) {
+      distinct += dict.signature(id).distinct;
+      rarity += dict.signature(id).rarity;
+    }
+    double n = ids.empty() ? 1 : static_cast<double>(ids.size());
+    std::cout << "  " << tier_names[t] << ": " << ids.size() << " words, "
+              << distinct / n << " distinct letters and " << rarity / n
+              << " bits of rarity on average\n";
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,227 @@
+/*!
+ * Load generator for the game server.
+ * @file loadgen.cpp
+ *
+ * Opens many connections to a hangman_server at once, and plays whole
+ * sessions on each, as fast as the server answers: log in, play one
+ * match guessing letters from the most to the least frequent, go back
+ * to the menu, quit, and log in again. Every guess is timed from the
+ * moment it is sent to the moment its answer arrives.
+ *
+ * Prints the sessions and guesses served per second, and the median
+ * and 99th percentile guess latency.
+ *
+ * Usage:
+ *   hangman_loadgen (--unix PATH | --port N) [--clients 64] [--sessions 10000]
+ */
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <string>
+#include <string_view>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+/// Letters guessed, most frequent in Portuguese first.
+static constexpr std::string_view LETTERS = "AEOSRINDMUTCLPVGHQBFZJXKWY";
+
+/// One simulated player.
+struct Client {
+  int fd = -1;              //!< The connection.
+  std::string name;         //!< The player's name.
+  std::string in;           //!< Bytes received, not handled yet.
+  size_t letter = 0;        //!< Next letter to guess.
+  bool quitting = false;    //!< Whether the match is over and the session is ending.
+  Clock::time_point sent;   //!< When the last guess was sent.
+};
+
+/// The whole run.
+struct Load {
+  size_t sessions = 0;            //!< Sessions to play, in all.
+  size_t started = 0;             //!< Sessions started.
+  size_t finished = 0;            //!< Sessions finished.
+  size_t errors = 0;              //!< Answers that were not expected.
+  std::vector<uint32_t> latency;  //!< Every guess latency, in microseconds.
+};
+
+/// Print how the program is run, and fail.
+static int usage(const char *program) {
+  std::fprintf(stderr, "Usage: %s (--unix PATH | --port N) [--clients 64] [--sessions 10000]\n", program);
+  return EXIT_FAILURE;
+}
+
+/// Connect to the server; -1 on failure.
+static int connect_to(const std::string &unix_path, uint16_t port) {
+  sockaddr_storage address{};
+  socklen_t size;
+  if (!unix_path.empty()) {
+    auto &un = reinterpret_cast<sockaddr_un &>(address);
+    un.sun_family = AF_UNIX;
+    std::strncpy(un.sun_path, unix_path.c_str(), sizeof(un.sun_path) - 1);
+    size = sizeof(sockaddr_un);
+  } else {
+    auto &in = reinterpret_cast<sockaddr_in &>(address);
+    in.sin_family = AF_INET;
+    in.sin_port = htons(port);
+    in.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    size = sizeof(sockaddr_in);
+  }
+  int fd = ::socket(address.ss_family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0) { return -1; }
+  if (::connect(fd, reinterpret_cast<sockaddr *>(&address), size) != 0) {
+    ::close(fd);
+    return -1;
+  }
+  if (unix_path.empty()) {
+    int yes = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+  }
+  return fd;
+}
+
+/// Send one line; false if the connection is gone.
+static bool send_line(const Client &client, std::string_view line) {
+  std::string text(line);
+  text += '\n';
+  return ::send(client.fd, text.data(), text.size(), MSG_NOSIGNAL) == static_cast<ssize_t>(text.size());
+}
+
+/// Start a session on the client's connection, if any are left to play.
+static bool start_session(Client &client, Load &load) {
+  if (load.started == load.sessions) { return false; }
+  ++load.started;
+  client.letter = 0;
+  client.quitting = false;
+  return send_line(client, client.name);
+}
+
+/// Answer one line from the server; false when the client is done.
+static bool on_answer(Client &client, Load &load, std::string_view answer) {
+  std::string_view screen = answer.substr(0, answer.find(' '));
+  if (screen == "ERROR" || screen == "BUSY") {
+    ++load.errors;
+    return false;
+  }
+  if (screen == "PLAYING" || screen == "WORD") {
+    if (client.letter != 0) {
+      load.latency.push_back(static_cast<uint32_t>(
+          std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - client.sent).count()));
+    }
+    if (screen == "WORD") {
+      client.sent = Clock::now();
+      return send_line(client, "?");
+    }
+    client.sent = Clock::now();
+    // Out of letters: guess a word that is not it, until the match is lost.
+    if (client.letter == LETTERS.size()) { return send_line(client, "&"); }
+    return send_line(client, LETTERS.substr(client.letter++, 1));
+  }
+  if (screen == "WON" || screen == "LOST") {
+    load.latency.push_back(static_cast<uint32_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - client.sent).count()));
+    client.quitting = true;
+    return send_line(client, "");
+  }
+  if (screen == "MENU") { return send_line(client, client.quitting ? "6" : "1"); }
+  if (screen == "QUITTING") { return send_line(client, "yes"); }
+  if (screen == "NO_WORDS") { return send_line(client, "yes"); }
+  if (screen == "BYE") {
+    ++load.finished;
+    return start_session(client, load);
+  }
+  ++load.errors;
+  return false;
+}
+
+/// Return the latency below which `fraction` of the guesses were answered.
+static uint32_t percentile(std::vector<uint32_t> &latency, double fraction) {
+  if (latency.empty()) { return 0; }
+  auto nth = latency.begin() + static_cast<ptrdiff_t>(fraction * static_cast<double>(latency.size() - 1));
+  std::nth_element(latency.begin(), nth, latency.end());
+  return *nth;
+}
+
+int main(int argc, char *argv[]) {
+  std::string unix_path;
+  long port = 0;
+  size_t n_clients = 64;
+  Load load;
+  load.sessions = 10000;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--unix") == 0 && i + 1 < argc) { unix_path = argv[++i]; }
+    else if (std::strcmp(argv[i], "--port") == 0 && i + 1 < argc) { port = std::strtol(argv[++i], nullptr, 10); }
+    else if (std::strcmp(argv[i], "--clients") == 0 && i + 1 < argc) { n_clients = std::strtoul(argv[++i], nullptr, 10); }
+    else if (std::strcmp(argv[i], "--sessions") == 0 && i + 1 < argc) { load.sessions = std::strtoul(argv[++i], nullptr, 10); }
+    else { return usage(argv[0]); }
+  }
+  if (unix_path.empty() == (port == 0) || port < 0 || port > 65535 || n_clients == 0) { return usage(argv[0]); }
+  load.latency.reserve(load.sessions * 16);
+
+  int epoll = ::epoll_create1(EPOLL_CLOEXEC);
+  std::vector<Client> clients(n_clients);
+  Clock::time_point begin = Clock::now();
+  size_t active = 0;
+  for (size_t i = 0; i < n_clients; ++i) {
+    Client &client = clients[i];
+    client.fd = connect_to(unix_path, static_cast<uint16_t>(port));
+    if (client.fd < 0) {
+      std::fprintf(stderr, "Unable to connect: %s\n", std::strerror(errno));
+      return EXIT_FAILURE;
+    }
+    client.name = "load" + std::to_string(i);
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.u64 = i;
+    ::epoll_ctl(epoll, EPOLL_CTL_ADD, client.fd, &event);
+    if (start_session(client, load)) { ++active; }
+  }
+
+  epoll_event events[64];
+  char buffer[4096];
+  while (active > 0) {
+    int n = ::epoll_wait(epoll, events, 64, -1);
+    if (n < 0 && errno == EINTR) { continue; }
+    if (n < 0) { break; }
+    for (int e = 0; e < n; ++e) {
+      Client &client = clients[events[e].data.u64];
+      ssize_t got = ::recv(client.fd, buffer, sizeof(buffer), 0);
+      bool open = got > 0;
+      if (open) { client.in.append(buffer, static_cast<size_t>(got)); }
+      size_t from = 0;
+      for (size_t end; open && (end = client.in.find('\n', from)) != std::string::npos; from = end + 1) {
+        open = on_answer(client, load, std::string_view(client.in).substr(from, end - from));
+      }
+      client.in.erase(0, from);
+      if (!open) {
+        ::epoll_ctl(epoll, EPOLL_CTL_DEL, client.fd, nullptr);
+        ::close(client.fd);
+        --active;
+      }
+    }
+  }
+  double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+  ::close(epoll);
+
+  size_t guesses = load.latency.size();
+  std::printf("clients:        %zu\n", n_clients);
+  std::printf("sessions:       %zu in %.3f s (%.0f sessions/s)\n", load.finished, seconds,
+              static_cast<double>(load.finished) / seconds);
+  std::printf("guesses:        %zu (%.0f guesses/s)\n", guesses, static_cast<double>(guesses) / seconds);
+  std::printf("guess latency:  p50 %u us, p99 %u us\n", percentile(load.latency, 0.50),
+              percentile(load.latency, 0.99));
+  if (load.errors != 0) { std::printf("errors:         %zu\n", load.errors); }
+  return load.errors == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
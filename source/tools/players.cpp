@@ -0,0 +1,123 @@
+/*!
+ * Player file converter.
+ * @file players.cpp
+ *
+ * Converts between the old Players.txt text format and the binary
+ * player store read by the game (see player_store.h). Converting a
+ * text file to the store and back gives the same players; records
+ * that still list played words by text are resolved to ids through
+ * the words file, as the game does.
+ *
+ * It also prints a page of the players, ranked in one of the
+ * leaderboard orders (see leaderboard.h), as CSV.
+ *
+ * Usage:
+ *   hangman_players import [Players.txt] [Players.dat] [words.csv]
+ *   hangman_players export [Players.dat] [Players.txt]
+ *   hangman_players top [score|hard|winrate|words] [page] [Players.dat]
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "../utils/utf8.h"
+#include "dictionary.h"
+#include "leaderboard.h"
+#include "player_store.h"
+
+/// Players per page printed by `top`.
+static constexpr size_t PAGE = 20;
+
+/// Return the index path that goes with a data path: Players.dat -> Players.idx.
+static std::string index_path_for(const std::string &data_path) {
+  size_t dot = data_path.rfind('.');
+  return (dot == std::string::npos ? data_path : data_path.substr(0, dot)) + ".idx";
+}
+
+static int import_text(const char *text_path, const std::string &data_path, const char *csv_path) {
+  Dictionary dictionary;
+  dictionary.build(csv_path); // Only needed for old records; may be missing.
+
+  // Build next to the target and rename, so the game never sees half a store.
+  std::string index_path = index_path_for(data_path);
+  std::string tmp_data = data_path + ".tmp", tmp_index = index_path + ".tmp";
+  std::remove(tmp_data.c_str());
+  size_t n_players = 0;
+  {
+    PlayerStore store(tmp_data, tmp_index);
+    if (!store.open() || !store.import_text(text_path, dictionary)) {
+      std::cerr << "Unable to convert " << text_path << '\n';
+      std::remove(tmp_data.c_str());
+      std::remove(tmp_index.c_str());
+      return EXIT_FAILURE;
+    }
+    n_players = store.size();
+  }
+  if (std::rename(tmp_data.c_str(), data_path.c_str()) != 0 ||
+      std::rename(tmp_index.c_str(), index_path.c_str()) != 0) {
+    std::cerr << "Unable to replace " << data_path << '\n';
+    return EXIT_FAILURE;
+  }
+  std::cout << "Converted " << n_players << " players into " << data_path << '\n';
+  return EXIT_SUCCESS;
+}
+
+static int export_text(const std::string &data_path, const char *text_path) {
+  PlayerStore store(data_path, index_path_for(data_path));
+  if (!store.exists() || !store.open() || !store.export_text(text_path)) {
+    std::cerr << "Unable to convert " << data_path << '\n';
+    return EXIT_FAILURE;
+  }
+  std::cout << "Wrote " << store.size() << " players to " << text_path << '\n';
+  return EXIT_SUCCESS;
+}
+
+static int print_top(const char *order_name, size_t page, const std::string &data_path) {
+  static const char *const orders[Leaderboard::N_ORDERS] = {"score", "hard", "winrate", "words"};
+  size_t order = 0;
+  while (order < Leaderboard::N_ORDERS && std::strcmp(orders[order], order_name) != 0) { ++order; }
+  if (order == Leaderboard::N_ORDERS) {
+    std::cerr << "Unknown order " << order_name << '\n';
+    return EXIT_FAILURE;
+  }
+  PlayerStore store(data_path, index_path_for(data_path));
+  if (!store.exists() || !store.open()) {
+    std::cerr << "Unable to open " << data_path << '\n';
+    return EXIT_FAILURE;
+  }
+  Leaderboard board;
+  store.for_each([&board](const Player &player) { board.update(player); });
+  std::cout << "rank,name,score,easy,normal,hard,words,wins,loses\n";
+  std::string name;
+  board.page(static_cast<Leaderboard::order_e>(order), (page - 1) * PAGE, PAGE,
+             [&name](size_t rank, const Leaderboard::Entry &e) {
+               name.clear();
+               utf8::encode(name, e.name);
+               std::cout << rank << ',' << name << ',' << e.score << ',' << e.easy << ','
+                         << e.medium << ',' << e.hard << ',' << e.words << ',' << e.wins << ','
+                         << e.loses << '\n';
+             });
+  return EXIT_SUCCESS;
+}
+
+int main(int argc, char *argv[]) {
+  if (argc > 1 && std::strcmp(argv[1], "import") == 0) {
+    return import_text(argc > 2 ? argv[2] : "Players.txt", argc > 3 ? argv[3] : "Players.dat",
+                       argc > 4 ? argv[4] : "words.csv");
+  }
+  if (argc > 1 && std::strcmp(argv[1], "export") == 0) {
+    return export_text(argc > 2 ? argv[2] : "Players.dat", argc > 3 ? argv[3] : "Players.txt");
+  }
+  if (argc > 1 && std::strcmp(argv[1], "top") == 0) {
+    size_t page = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 1;
+    return print_top(argc > 2 ? argv[2] : "score", page > 0 ? page : 1,
+                     argc > 4 ? argv[4] : "Players.dat");
+  }
+  std::cerr << "Usage: " << argv[0] << " import [Players.txt] [Players.dat] [words.csv]\n"
+            << "       " << argv[0] << " export [Players.dat] [Players.txt]\n"
+            << "       " << argv[0] << " top [score|hard|winrate|words] [page] [Players.dat]\n";
+  return EXIT_FAILURE;
+}
@@ -0,0 +1,75 @@
+/*!
+ * Game server.
+ * @file server.cpp
+ *
+ * Serves the game to many players at once over a Unix domain socket or
+ * a localhost TCP port, with one dictionary and one player store shared
+ * by every session (see game_server.h for the protocol). Runs until
+ * interrupted. The words are reloaded when the words file changes, or
+ * on SIGHUP.
+ *
+ * Usage:
+ *   hangman_server (--unix PATH | --port N) [--words words.csv] [--players Players.dat]
+ */
+
+#include <clocale>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include "game_server.h"
+
+/// Set by SIGINT and SIGTERM.
+static volatile bool stop = false;
+/// The server, for SIGHUP.
+static GameServer *g_server = nullptr;
+
+static void on_signal(int) { stop = true; }
+static void on_hangup(int) {
+  if (g_server != nullptr) { g_server->reload_words(); }
+}
+
+/// Print how the program is run, and fail.
+static int usage(const char *program) {
+  std::wcerr << L"Usage: " << program << L" (--unix PATH | --port N) [--words words.csv] [--players Players.dat]\n";
+  return EXIT_FAILURE;
+}
+
+int main(int argc, char *argv[]) {
+  std::setlocale(LC_ALL, "pt_BR.utf8");
+  ServerOptions options;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--unix") == 0 && i + 1 < argc) { options.unix_path = argv[++i]; }
+    else if (std::strcmp(argv[i], "--port") == 0 && i + 1 < argc) {
+      long port = std::strtol(argv[++i], nullptr, 10);
+      if (port <= 0 || port > 65535) { return usage(argv[0]); }
+      options.port = static_cast<uint16_t>(port);
+    }
+    else if (std::strcmp(argv[i], "--words") == 0 && i + 1 < argc) { options.words_path = argv[++i]; }
+    else if (std::strcmp(argv[i], "--players") == 0 && i + 1 < argc) { options.players_path = argv[++i]; }
+    else { return usage(argv[0]); }
+  }
+  if (options.unix_path.empty() == (options.port == 0)) { return usage(argv[0]); }
+
+  // No SA_RESTART: a signal interrupts the wait for events, so the loop sees `stop`.
+  struct sigaction action {};
+  action.sa_handler = on_signal;
+  sigemptyset(&action.sa_mask);
+  sigaction(SIGINT, &action, nullptr);
+  sigaction(SIGTERM, &action, nullptr);
+
+  GameServer server(options);
+  if (!server.start()) { return EXIT_FAILURE; }
+  g_server = &server;
+  struct sigaction hangup {};
+  hangup.sa_handler = on_hangup;
+  hangup.sa_flags = SA_RESTART;
+  sigemptyset(&hangup.sa_mask);
+  sigaction(SIGHUP, &hangup, nullptr);
+  std::wcerr << L"Serving on " << (options.unix_path.empty() ? std::to_string(options.port).c_str() : options.unix_path.c_str())
+             << std::endl;
+  server.run(stop);
+  std::wcerr << server.n_sessions() << L" sessions served." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,102 @@
+#ifndef FLOW_H
+#define FLOW_H
+
+/*!
+ * Coroutine flows.
+ *
+ * A Flow is a C++20 coroutine that tells a story in order (show the
+ * menu, wait for a key, play a match, ...) and suspends wherever it
+ * needs something from outside, such as the next input. Its owner
+ * resumes it when that arrives. A Flow may co_await another Flow, and
+ * gets its co_returned value:
+ *
+ * ```c++
+ *  Flow<bool> confirm();  // co_return true or false.
+ *  Flow<> menu() {
+ *    while (true) {
+ *      wchar_t key = co_await next_key();
+ *      if (key == L'6' && co_await confirm()) { co_return; }
+ *    }
+ *  }
+ * ```
+ *
+ * A flow starts suspended, and runs when first resumed (start(), or
+ * being awaited). A flow that ends goes straight back to the one that
+ * awaited it, with no trip through the owner. Its frame, with every
+ * local that lives across a suspension, is allocated once when it is
+ * called and freed with the Flow object; suspending and resuming
+ * allocate nothing.
+ */
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+template <typename T = void> class Flow;
+
+namespace flow_detail {
+/// Where a flow keeps what it co_returns.
+template <typename T> struct Result {
+  T value{}; //!< The value co_returned.
+  void return_value(T v) { value = std::move(v); }
+  T take() { return std::move(value); }
+};
+
+template <> struct Result<void> {
+  void return_void() {}
+  void take() {}
+};
+} // namespace flow_detail
+
+template <typename T> class Flow {
+public:
+  struct promise_type : flow_detail::Result<T> {
+    std::coroutine_handle<> caller = std::noop_coroutine(); //!< Flow to go on with at the end; none at the top.
+
+    Flow get_return_object() { return Flow{std::coroutine_handle<promise_type>::from_promise(*this)}; }
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    auto final_suspend() noexcept {
+      struct Return {
+        bool await_ready() noexcept { return false; }
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> flow) noexcept {
+          return flow.promise().caller;
+        }
+        void await_resume() noexcept {}
+      };
+      return Return{};
+    }
+    void unhandled_exception() { std::terminate(); }
+  };
+
+private:
+  std::coroutine_handle<promise_type> m_handle; //!< The coroutine; owned.
+
+  explicit Flow(std::coroutine_handle<promise_type> handle) : m_handle{handle} {}
+
+public:
+  Flow() = default;
+  Flow(Flow &&other) noexcept : m_handle{std::exchange(other.m_handle, nullptr)} {}
+  Flow &operator=(Flow &&other) noexcept {
+    std::swap(m_handle, other.m_handle);
+    return *this;
+  }
+  /// Frees the frame, and every flow it is awaiting.
+  ~Flow() {
+    if (m_handle) { m_handle.destroy(); }
+  }
+
+  /// Run a flow nobody awaits up to its first suspension.
+  void start() { m_handle.resume(); }
+
+  /// Return whether the flow ran to its end.
+  [[nodiscard]] bool done() const { return !m_handle || m_handle.done(); }
+
+  //=== Awaiting a flow runs it, and gives what it co_returns.
+  bool await_ready() const noexcept { return false; }
+  std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) noexcept {
+    m_handle.promise().caller = caller;
+    return m_handle;
+  }
+  T await_resume() { return m_handle.promise().take(); }
+};
+
+#endif
@@ -0,0 +1,210 @@
+#ifndef FRAME_H
+#define FRAME_H
+
+/*!
+ * Frame buffered terminal output.
+ *
+ * A Frame is a wide output stream that composes a whole screen in
+ * memory. present() sends it to the terminal in one write, UTF-8
+ * encoded, so redrawing the screen neither starts a `clear` process
+ * nor flushes once per line.
+ *
+ * ```c++
+ *  Frame frame;
+ *  frame.begin();
+ *  frame << L"Score: " << 10 << L'\n';
+ *  frame.present();
+ * ```
+ *
+ * The frame last shown is kept, and the next one is sent as a diff
+ * against it: for every line that changed, the cursor is moved (with
+ * ANSI cursor addressing) to the first character that differs and only
+ * the rest of the line is written. Anything below the frame, such as
+ * the echo of what the user typed, is cleared. A diff that would not
+ * be smaller than the whole frame, and any frame too tall for the
+ * terminal to show without scrolling, or with a line too wide to show
+ * without wrapping (which would push the lines below it off the rows
+ * the diff addresses), is sent whole after the ANSI "cursor home,
+ * clear screen" sequence instead.
+ *
+ * Lines holding escape sequences are compared whole, and must not
+ * leave a style active at their end.
+ *
+ * All buffers are reserved up front and keep their capacity between
+ * frames, so drawing a frame does not allocate.
+ */
+#include <cerrno>
+#include <cstddef>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <string_view>
+
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include <wchar.h>
+
+#include "utf8.h"
+
+class Frame : public std::wostream {
+private:
+  /// Appends everything written to a string.
+  class Buffer : public std::wstreambuf {
+  public:
+    std::wstring text; //!< The frame so far.
+
+  protected:
+    int_type overflow(int_type c) override {
+      if (!traits_type::eq_int_type(c, traits_type::eof())) {
+        text.push_back(traits_type::to_char_type(c));
+      }
+      return traits_type::not_eof(c);
+    }
+    std::streamsize xsputn(const wchar_t *s, std::streamsize n) override {
+      text.append(s, static_cast<size_t>(n));
+      return n;
+    }
+  };
+
+  Buffer m_buffer;       //!< The frame being composed.
+  std::wstring m_shown;  //!< The frame on the terminal.
+  bool m_valid = false;  //!< Whether the terminal still shows m_shown.
+  std::string m_bytes;   //!< What is sent to the terminal.
+  int m_fd;              //!< Where frames are written.
+
+public:
+  /// Cursor home, then clear the screen.
+  static constexpr std::string_view CLEAR = "\x1b[H\x1b[2J";
+  /// Characters reserved for a frame; larger frames grow the buffers once.
+  static constexpr size_t RESERVE = 16384;
+  /// Terminal rows kept free under a diffed frame, for input and messages.
+  static constexpr size_t MARGIN = 4;
+
+  /// Create a frame that is presented on `fd`.
+  explicit Frame(int fd = STDOUT_FILENO) : std::wostream(nullptr), m_fd{fd} {
+    rdbuf(&m_buffer);
+    m_buffer.text.reserve(RESERVE);
+    m_shown.reserve(RESERVE);
+    m_bytes.reserve(CLEAR.size() + RESERVE * 2);
+  }
+  Frame(const Frame &) = delete;
+  Frame &operator=(const Frame &) = delete;
+
+  /// Start a new, empty frame.
+  void begin() {
+    m_buffer.text.clear();
+    std::wostream::clear();
+  }
+
+  /// Return the frame composed so far.
+  [[nodiscard]] std::wstring_view text() const { return m_buffer.text; }
+
+  /// Send the next frame whole, e.g. after something else drew on the terminal.
+  void invalidate() { m_valid = false; }
+
+  /**
+   * @brief Show the frame, in one write.
+   *
+   * @return false if the frame could not be written.
+   */
+  bool present() {
+    m_bytes.clear();
+    bool diffed = m_valid && fits();
+    if (diffed) { diff(); }
+    if (!diffed || m_bytes.size() >= CLEAR.size() + m_buffer.text.size()) {
+      m_bytes.assign(CLEAR);
+      utf8::encode(m_bytes, m_buffer.text);
+    }
+    m_shown.swap(m_buffer.text);
+    m_valid = true;
+
+    const char *data = m_bytes.data();
+    size_t left = m_bytes.size();
+    while (left > 0) {
+      ssize_t written = ::write(m_fd, data, left);
+      if (written < 0 && errno == EINTR) { continue; }
+      if (written <= 0) {
+        m_valid = false;
+        return false;
+      }
+      data += written;
+      left -= static_cast<size_t>(written);
+    }
+    return true;
+  }
+
+private:
+  /// Return whether the frame fits the terminal with MARGIN rows to spare, each line on one row.
+  [[nodiscard]] bool fits() const {
+    winsize size{};
+    if (::ioctl(m_fd, TIOCGWINSZ, &size) != 0 || size.ws_row == 0) { return true; } // Not a terminal.
+    size_t rows = MARGIN, columns = 0;
+    enum { TEXT, ESCAPE, CSI } state = TEXT; // Escape sequences take no room.
+    for (wchar_t c : m_buffer.text) {
+      if (state == ESCAPE) {
+        state = c == L'[' ? CSI : TEXT;
+      } else if (state == CSI) {
+        if (c >= L'@' && c <= L'~') { state = TEXT; } // The final byte.
+      } else if (c == L'\x1b') {
+        state = ESCAPE;
+      } else if (c == L'\n') {
+        ++rows;
+        columns = 0;
+      } else {
+        int width = ::wcwidth(c);
+        columns += width >= 0 ? static_cast<size_t>(width) : 1;
+        if (size.ws_col != 0 && columns > size.ws_col) { return false; }
+      }
+    }
+    return rows <= size.ws_row;
+  }
+
+  /// Remove and return the first line of `text`, without its '\n'.
+  static std::wstring_view take_line(std::wstring_view &text) {
+    size_t end = text.find(L'\n');
+    std::wstring_view line = text.substr(0, end);
+    text.remove_prefix(end == std::wstring_view::npos ? text.size() : end + 1);
+    return line;
+  }
+
+  /// Append the sequence that moves the cursor to `row`, `column` (from 1).
+  void move_to(size_t row, size_t column) {
+    m_bytes += "\x1b[";
+    m_bytes += std::to_string(row);
+    m_bytes += ';';
+    m_bytes += std::to_string(column);
+    m_bytes += 'H';
+  }
+
+  /// Append the changes from m_shown to the new frame.
+  void diff() {
+    std::wstring_view now = m_buffer.text, before = m_shown;
+    size_t row = 1, end_column = 1;
+    while (!now.empty()) {
+      bool whole = now.find(L'\n') != std::wstring_view::npos;
+      std::wstring_view line = take_line(now), old = take_line(before);
+      if (line != old) {
+        // Skip the characters that did not change, unless the line is styled.
+        bool styled = line.find(L'\x1b') != std::wstring_view::npos ||
+                      old.find(L'\x1b') != std::wstring_view::npos;
+        size_t same = 0;
+        while (!styled && same < line.size() && same < old.size() && line[same] == old[same]) {
+          ++same;
+        }
+        move_to(row, same + 1);
+        utf8::encode(m_bytes, line.substr(same));
+        if (styled || old.size() > line.size()) { m_bytes += "\x1b[K"; }
+      }
+      if (!whole) {
+        end_column = line.size() + 1;
+        break;
+      }
+      ++row;
+    }
+    // Leave the cursor where the whole frame would, and clear below it.
+    move_to(row, end_column);
+    m_bytes += "\x1b[J";
+  }
+};
+
+#endif
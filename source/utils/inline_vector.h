@@ -0,0 +1,37 @@
+#ifndef INLINE_VECTOR_H
+#define INLINE_VECTOR_H
+
+/*!
+ * Fixed capacity vector stored inline.
+ *
+ * Behaves like a small std::vector whose elements live inside the
+ * object itself, so it never touches the heap. Pushing past the
+ * capacity is refused (push_back() returns false) instead of growing.
+ */
+#include <array>
+#include <cstddef>
+
+template <typename T, size_t N> class InlineVector {
+private:
+  std::array<T, N> m_data{}; //!< Element storage.
+  size_t m_size = 0;         //!< Number of elements in use.
+
+public:
+  /// Appends a copy of `value`, if there is room left.
+  bool push_back(const T &value) {
+    if (m_size == N) { return false; }
+    m_data[m_size++] = value;
+    return true;
+  }
+
+  /// Removes every element.
+  void clear() { m_size = 0; }
+
+  [[nodiscard]] size_t size() const { return m_size; }
+  [[nodiscard]] bool empty() const { return m_size == 0; }
+  [[nodiscard]] static constexpr size_t capacity() { return N; }
+  [[nodiscard]] const T *begin() const { return m_data.data(); }
+  [[nodiscard]] const T *end() const { return m_data.data() + m_size; }
+  const T &operator[](size_t i) const { return m_data[i]; }
+};
+#endif
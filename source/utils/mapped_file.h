@@ -0,0 +1,172 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+/*!
+ * Memory mapped files.
+ *
+ * MappedFile maps a whole file read-only so it can be scanned in place,
+ * without copying it into stream buffers first.
+ *
+ * ```c++
+ *  MappedFile file("words.csv");
+ *  if (file.is_open()) {
+ *      std::string_view contents = file.view();
+ *  }
+ * ```
+ *
+ * SharedMappedFile maps a file read-write and shared, so stores to the
+ * mapping update the file in place, and can grow it.
+ */
+#include <cstddef>
+#include <string_view>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+class MappedFile {
+private:
+  const char *m_data = nullptr; //!< First byte of the mapping.
+  size_t m_size = 0;            //!< Size of the mapped file, in bytes.
+  bool m_open = false;          //!< Whether the file has been opened.
+
+public:
+  MappedFile() = default;
+  /// Maps the file at `path`; check is_open() for the result.
+  explicit MappedFile(const char *path) { open(path); }
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+  MappedFile(MappedFile &&other) noexcept { *this = std::move(other); }
+  MappedFile &operator=(MappedFile &&other) noexcept {
+    if (this != &other) {
+      close();
+      m_data = std::exchange(other.m_data, nullptr);
+      m_size = std::exchange(other.m_size, 0);
+      m_open = std::exchange(other.m_open, false);
+    }
+    return *this;
+  }
+  ~MappedFile() { close(); }
+
+  /// Maps the file read-only. An empty file opens as an empty view.
+  /*!
+   * @param path Path of the file to map.
+   * @return true if the file could be opened and mapped.
+   */
+  bool open(const char *path) {
+    close();
+    int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) { return false; }
+    struct stat st {};
+    if (::fstat(fd, &st) != 0) {
+      ::close(fd);
+      return false;
+    }
+    if (st.st_size > 0) {
+      void *addr = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ,
+                          MAP_PRIVATE, fd, 0);
+      if (addr == MAP_FAILED) {
+        ::close(fd);
+        return false;
+      }
+      ::madvise(addr, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+      m_data = static_cast<const char *>(addr);
+      m_size = static_cast<size_t>(st.st_size);
+    }
+    ::close(fd); // The mapping keeps its own reference to the file.
+    m_open = true;
+    return true;
+  }
+
+  /// Unmaps the file, if any.
+  void close() {
+    if (m_data != nullptr) {
+      ::munmap(const_cast<char *>(m_data), m_size);
+    }
+    m_data = nullptr;
+    m_size = 0;
+    m_open = false;
+  }
+
+  [[nodiscard]] bool is_open() const { return m_open; }
+  [[nodiscard]] const char *data() const { return m_data; }
+  [[nodiscard]] size_t size() const { return m_size; }
+  /// Returns the whole file contents.
+  [[nodiscard]] std::string_view view() const { return {m_data, m_size}; }
+};
+
+class SharedMappedFile {
+private:
+  char *m_data = nullptr; //!< First byte of the mapping.
+  size_t m_size = 0;      //!< Size of the mapped file, in bytes.
+  int m_fd = -1;          //!< The file, kept open to resize it.
+
+public:
+  SharedMappedFile() = default;
+  SharedMappedFile(const SharedMappedFile &) = delete;
+  SharedMappedFile &operator=(const SharedMappedFile &) = delete;
+  ~SharedMappedFile() { close(); }
+
+  /// Opens (creating it if needed) and maps the file read-write.
+  /*!
+   * @param path Path of the file to map.
+   * @return true if the file could be opened and mapped.
+   */
+  bool open(const char *path) {
+    close();
+    m_fd = ::open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (m_fd < 0) { return false; }
+    struct stat st {};
+    if (::fstat(m_fd, &st) != 0 || !map(static_cast<size_t>(st.st_size))) {
+      close();
+      return false;
+    }
+    return true;
+  }
+
+  /// Grows or shrinks the file to `size` bytes and maps it again.
+  /*!
+   * Pointers into the old mapping are invalidated.
+   */
+  bool resize(size_t size) {
+    if (m_fd < 0 || ::ftruncate(m_fd, static_cast<off_t>(size)) != 0) { return false; }
+    return map(size);
+  }
+
+  /// Flushes changes to the file.
+  void sync() {
+    if (m_data != nullptr) { ::msync(m_data, m_size, MS_SYNC); }
+  }
+
+  /// Unmaps and closes the file, if any.
+  void close() {
+    unmap();
+    if (m_fd >= 0) { ::close(m_fd); }
+    m_fd = -1;
+  }
+
+  [[nodiscard]] bool is_open() const { return m_fd >= 0; }
+  [[nodiscard]] char *data() { return m_data; }
+  [[nodiscard]] const char *data() const { return m_data; }
+  [[nodiscard]] size_t size() const { return m_size; }
+
+private:
+  bool map(size_t size) {
+    unmap();
+    if (size == 0) { return true; }
+    void *addr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    if (addr == MAP_FAILED) { return false; }
+    m_data = static_cast<char *>(addr);
+    m_size = size;
+    return true;
+  }
+
+  void unmap() {
+    if (m_data != nullptr) { ::munmap(m_data, m_size); }
+    m_data = nullptr;
+    m_size = 0;
+  }
+};
+#endif
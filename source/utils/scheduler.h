@@ -0,0 +1,324 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+/*!
+ * Work stealing task scheduler.
+ *
+ * Runs tasks, such as sessions with input ready, on a fixed set of
+ * worker threads, each pinned to a core. Every worker owns a run queue,
+ * a Chase-Lev deque: the worker pushes and pops at its bottom with no
+ * atomic read-modify-write unless a single task is left, and idle
+ * workers steal from its top with one compare-and-swap. There is no
+ * mutex anywhere a task is run, queued or stolen.
+ *
+ * ```c++
+ *  struct Play : Scheduler::Task {
+ *    bool run() override { return handle_ready_input(); } // true: run again.
+ *  };
+ *  Scheduler scheduler(4);
+ *  for (Play &play : plays) { scheduler.submit(play); }
+ *  scheduler.run(); // Returns once stop() is called, from a task or any thread.
+ * ```
+ *
+ * A task stays on the worker that ran it last: one that asks to run
+ * again goes back on that worker's own queue, so its state stays in
+ * that core's cache, and moves only when an idle worker steals it.
+ * Tasks made ready by another thread (say, on input from the network)
+ * are posted to their worker's inbox, a lock-free stack the worker
+ * drains into its queue. Workers keep running while no task is ready,
+ * spinning for a while and then sleeping until a task is posted, and
+ * run() returns only once stop() is called.
+ *
+ * The scheduler does not own tasks, and runs a task on one worker at a
+ * time.
+ */
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <pthread.h>
+#include <sched.h>
+
+class Scheduler {
+public:
+  /// Something to run.
+  class Task {
+    friend class Scheduler;
+    Task *m_next = nullptr;          //!< Next task in an inbox.
+    std::atomic<size_t> m_worker{0}; //!< Worker the task was last queued on; read by posting threads.
+
+  public:
+    virtual ~Task() = default;
+
+    /**
+     * @brief Run the task for a while.
+     *
+     * @return true to be run again, false to wait until it is posted again.
+     */
+    virtual bool run() = 0;
+  };
+
+private:
+  /// A Chase-Lev work stealing deque (Lê et al., "Correct and efficient
+  /// work-stealing for weak memory models", 2013).
+  class Deque {
+    /// A ring of task slots; replaced by one twice as large when full.
+    struct Ring {
+      size_t mask;                           //!< Slots - 1; the slots are a power of two.
+      std::unique_ptr<std::atomic<Task *>[]> slots; //!< The slots.
+
+      explicit Ring(size_t size) : mask{size - 1}, slots{new std::atomic<Task *>[size]} {}
+      Task *get(int64_t i) const { return slots[static_cast<size_t>(i) & mask].load(std::memory_order_relaxed); }
+      void put(int64_t i, Task *task) { slots[static_cast<size_t>(i) & mask].store(task, std::memory_order_relaxed); }
+    };
+
+    alignas(64) std::atomic<int64_t> m_top{0};    //!< Next task to steal.
+    alignas(64) std::atomic<int64_t> m_bottom{0}; //!< Next free slot; owner only.
+    std::atomic<Ring *> m_ring;                   //!< The current ring.
+    std::vector<std::unique_ptr<Ring>> m_rings;   //!< Every ring; old ones may still be read by thieves.
+
+  public:
+    explicit Deque(size_t size = 256) {
+      m_rings.push_back(std::make_unique<Ring>(size));
+      m_ring.store(m_rings.back().get(), std::memory_order_relaxed);
+    }
+
+    /// Push a task at the bottom; owner only.
+    void push(Task *task) {
+      int64_t b = m_bottom.load(std::memory_order_relaxed);
+      int64_t t = m_top.load(std::memory_order_acquire);
+      Ring *ring = m_ring.load(std::memory_order_relaxed);
+      if (b - t > static_cast<int64_t>(ring->mask)) {
+        auto larger = std::make_unique<Ring>((ring->mask + 1) * 2);
+        for (int64_t i = t; i < b; ++i) { larger->put(i, ring->get(i)); }
+        ring = larger.get();
+        m_rings.push_back(std::move(larger));
+        m_ring.store(ring, std::memory_order_release);
+      }
+      ring->put(b, task);
+      std::atomic_thread_fence(std::memory_order_release);
+      m_bottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    /// Pop the task at the bottom, the last pushed; owner only. nullptr if empty.
+    Task *pop() {
+      int64_t b = m_bottom.load(std::memory_order_relaxed) - 1;
+      Ring *ring = m_ring.load(std::memory_order_relaxed);
+      m_bottom.store(b, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      int64_t t = m_top.load(std::memory_order_relaxed);
+      if (t > b) {
+        m_bottom.store(b + 1, std::memory_order_relaxed);
+        return nullptr;
+      }
+      Task *task = ring->get(b);
+      if (t == b) {
+        // The last one: race the thieves for it.
+        if (!m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+          task = nullptr;
+        }
+        m_bottom.store(b + 1, std::memory_order_relaxed);
+      }
+      return task;
+    }
+
+    /// Steal the task at the top, the oldest; any thread. nullptr if empty or lost to another thief.
+    Task *steal() {
+      int64_t t = m_top.load(std::memory_order_acquire);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      int64_t b = m_bottom.load(std::memory_order_acquire);
+      if (t >= b) { return nullptr; }
+      Task *task = m_ring.load(std::memory_order_acquire)->get(t);
+      if (!m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        return nullptr;
+      }
+      return task;
+    }
+  };
+
+  /// A worker thread and what it runs.
+  struct alignas(64) Worker {
+    Deque queue;                       //!< Tasks to run; stolen from the top.
+    std::atomic<Task *> inbox{nullptr}; //!< Tasks posted by other threads, newest first.
+    uint64_t steal_seed = 0;           //!< Picks the victims to steal from.
+    size_t runs = 0;                   //!< Tasks run.
+    size_t steals = 0;                 //!< Tasks stolen from other workers.
+  };
+
+  std::vector<std::unique_ptr<Worker>> m_workers; //!< One per thread.
+  std::atomic<bool> m_stopping{false};            //!< Set by stop(); ends run().
+  std::atomic<uint32_t> m_signal{0};              //!< Bumped by every post and by stop(); sleeping workers wait on it.
+  std::atomic<size_t> m_sleeping{0};              //!< Workers waiting on m_signal.
+  size_t m_next = 0;                              //!< Worker the next submitted task goes to.
+
+  /// Rounds a worker finds nothing to run before it goes to sleep.
+  static constexpr size_t SPINS = 1024;
+
+public:
+  /// Start no threads yet; run() does.
+  explicit Scheduler(size_t n_workers) {
+    for (size_t i = 0; i < n_workers; ++i) {
+      m_workers.push_back(std::make_unique<Worker>());
+      m_workers.back()->steal_seed = 0x9E3779B97F4A7C15ull * (i + 1);
+    }
+  }
+  Scheduler(const Scheduler &) = delete;
+  Scheduler &operator=(const Scheduler &) = delete;
+
+  /// Return the number of workers.
+  [[nodiscard]] size_t n_workers() const { return m_workers.size(); }
+
+  /// Queue a task, spreading tasks over the workers in turn; only while run() is not running.
+  void submit(Task &task) {
+    task.m_worker.store(m_next, std::memory_order_relaxed);
+    m_workers[m_next]->queue.push(&task);
+    m_next = (m_next + 1) % m_workers.size();
+  }
+
+  /**
+   * @brief Queue a task that became ready, on the worker it last ran on;
+   * from any thread, while run() is running too.
+   *
+   * The task must not be queued already: post it again only after its
+   * run() returned false.
+   */
+  void post(Task &task) {
+    std::atomic<Task *> &inbox = m_workers[task.m_worker.load(std::memory_order_relaxed)]->inbox;
+    task.m_next = inbox.load(std::memory_order_relaxed);
+    while (!inbox.compare_exchange_weak(task.m_next, &task, std::memory_order_seq_cst, std::memory_order_relaxed)) {}
+    wake();
+  }
+
+  /// Make run() return, once every worker is done with the task it runs; from any thread, or from a task.
+  void stop() {
+    m_stopping.store(true, std::memory_order_seq_cst);
+    m_signal.fetch_add(1, std::memory_order_seq_cst);
+    m_signal.notify_all();
+  }
+
+  /**
+   * @brief Run the queued tasks, and those posted later, on the workers
+   * until stop() is called.
+   *
+   * The calling thread is worker 0, pinned like the others while it
+   * runs; it gets back the cores it was allowed on before returning.
+   */
+  void run() {
+    cpu_set_t caller_cores;
+    bool saved = ::pthread_getaffinity_np(::pthread_self(), sizeof(caller_cores), &caller_cores) == 0;
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < m_workers.size(); ++i) { threads.emplace_back([this, i] { work(i); }); }
+    work(0);
+    for (std::thread &thread : threads) { thread.join(); }
+    if (saved) { ::pthread_setaffinity_np(::pthread_self(), sizeof(caller_cores), &caller_cores); }
+  }
+
+  /// Return the number of tasks run by the workers, in all.
+  [[nodiscard]] size_t runs() const {
+    size_t n = 0;
+    for (const auto &worker : m_workers) { n += worker->runs; }
+    return n;
+  }
+
+  /// Return the number of tasks stolen, in all.
+  [[nodiscard]] size_t steals() const {
+    size_t n = 0;
+    for (const auto &worker : m_workers) { n += worker->steals; }
+    return n;
+  }
+
+private:
+  /// Worker `index`'s loop.
+  void work(size_t index) {
+    Worker &self = *m_workers[index];
+    pin(index);
+    size_t idle = 0;
+    while (!m_stopping.load(std::memory_order_acquire)) {
+      Task *task = self.queue.pop();
+      if (task == nullptr) { task = drain_inbox(self, index); }
+      if (task == nullptr && (task = steal(self, index)) != nullptr) { ++self.steals; }
+      if (task == nullptr) {
+        // Nothing anywhere: back off, the longer the idler, then sleep.
+        if (++idle > SPINS) {
+          sleep(self);
+          idle = 0;
+        } else if (idle > 64) {
+          std::this_thread::yield();
+        }
+        continue;
+      }
+      idle = 0;
+      task->m_worker.store(index, std::memory_order_relaxed);
+      ++self.runs;
+      if (task->run()) { self.queue.push(task); }
+    }
+  }
+
+  /// Move the tasks posted to a worker into its queue, and return one of them, or nullptr.
+  Task *drain_inbox(Worker &self, size_t index) {
+    Task *task = self.inbox.exchange(nullptr, std::memory_order_acquire);
+    if (task == nullptr) { return nullptr; }
+    Task *first = task;
+    task = task->m_next;
+    while (task != nullptr) {
+      // Once queued the task may be stolen, run and posted again, which rewrites m_next.
+      Task *next = task->m_next;
+      task->m_worker.store(index, std::memory_order_relaxed);
+      self.queue.push(task);
+      task = next;
+    }
+    return first;
+  }
+
+  /// Wake the sleeping workers, if any, after a post.
+  void wake() {
+    m_signal.fetch_add(1, std::memory_order_seq_cst);
+    if (m_sleeping.load(std::memory_order_seq_cst) != 0) { m_signal.notify_all(); }
+  }
+
+  /**
+   * @brief Sleep until a task is posted or stop() is called.
+   *
+   * A post either sees this worker counted in m_sleeping and bumps the
+   * signal it waits on, or comes early enough for the inbox check to see it.
+   */
+  void sleep(Worker &self) {
+    uint32_t signal = m_signal.load(std::memory_order_seq_cst);
+    m_sleeping.fetch_add(1, std::memory_order_seq_cst);
+    if (self.inbox.load(std::memory_order_seq_cst) == nullptr && !m_stopping.load(std::memory_order_seq_cst)) {
+      m_signal.wait(signal, std::memory_order_seq_cst);
+    }
+    m_sleeping.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  /// Steal a task from another worker, trying each once from a random one on.
+  Task *steal(Worker &self, size_t index) {
+    size_t n = m_workers.size();
+    if (n == 1) { return nullptr; }
+    self.steal_seed ^= self.steal_seed << 13;
+    self.steal_seed ^= self.steal_seed >> 7;
+    self.steal_seed ^= self.steal_seed << 17;
+    size_t start = static_cast<size_t>(self.steal_seed % n);
+    for (size_t k = 0; k < n; ++k) {
+      size_t victim = (start + k) % n;
+      if (victim == index) { continue; }
+      if (Task *task = m_workers[victim]->queue.steal()) { return task; }
+    }
+    return nullptr;
+  }
+
+  /// Keep worker `index` on one core, if the system lets it.
+  static void pin(size_t index) {
+    size_t n_cores = std::thread::hardware_concurrency();
+    if (n_cores == 0) { return; }
+    cpu_set_t cores;
+    CPU_ZERO(&cores);
+    CPU_SET(index % n_cores, &cores);
+    ::pthread_setaffinity_np(::pthread_self(), sizeof(cores), &cores);
+  }
+};
+
+#endif
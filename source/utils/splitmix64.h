@@ -0,0 +1,35 @@
+#ifndef SPLITMIX64_H
+#define SPLITMIX64_H
+
+/*!
+ * SplitMix64 random generator.
+ *
+ * Eight bytes of state, where std::mt19937 keeps five kilobytes: cheap
+ * enough for every idle session to own one. It meets the standard
+ * UniformRandomBitGenerator requirements, so the <random> distributions
+ * take it. Not for anything that must be unpredictable.
+ */
+#include <cstdint>
+#include <limits>
+
+class SplitMix64 {
+private:
+  uint64_t m_state; //!< Advanced by a fixed odd step on each draw.
+
+public:
+  using result_type = uint64_t;
+
+  explicit SplitMix64(uint64_t seed) : m_state{seed} { /*empty*/ }
+
+  [[nodiscard]] static constexpr result_type min() { return 0; }
+  [[nodiscard]] static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+  /// Returns the next 64 random bits.
+  result_type operator()() {
+    uint64_t z = (m_state += 0x9e3779b97f4a7c15);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+    return z ^ (z >> 31);
+  }
+};
+#endif
@@ -0,0 +1,410 @@
+#ifndef TERMINAL_H
+#define TERMINAL_H
+
+/*!
+ * Terminal input.
+ *
+ * Terminal reads keystrokes straight from a file descriptor. When it
+ * is a terminal it is switched to raw mode (no line buffering, no
+ * echo) on the first read and restored when the Terminal is destroyed,
+ * at exit, or when the program is stopped by a signal, so each key is
+ * seen as soon as it is pressed.
+ *
+ * Bytes are read through poll() into a fixed buffer and decoded by a
+ * table driven state machine: each byte is classified, and the pair
+ * (state, class) gives the next state and what to emit. It decodes
+ * UTF-8 into characters, Enter, Backspace, and escape sequences (arrow
+ * and function keys, reported as SEQUENCE); an escape not followed by
+ * anything within ESCAPE_TIMEOUT_MS is the Escape key. Nothing is
+ * allocated per key.
+ *
+ * ```c++
+ *  Terminal terminal;
+ *  Terminal::Key key = terminal.read_key();
+ *  if (key.type == Terminal::key_e::CHAR) { ... key.ch ... }
+ * ```
+ *
+ * When the input is not a terminal (a file or a pipe) it is read by
+ * lines: read_key() returns the first character of the next line, or
+ * ENTER for an empty one, and skips the rest of the line.
+ */
+#include <array>
+#include <cerrno>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+class Terminal {
+public:
+  /// What a key is.
+  enum class key_e : uint8_t {
+    CHAR,      //!< A character, in Key::ch.
+    ENTER,     //!< The Enter key.
+    BACKSPACE, //!< Backspace or Delete.
+    ESCAPE,    //!< The Escape key.
+    SEQUENCE,  //!< An arrow, function or other special key.
+    TIMEOUT,   //!< No key within the timeout.
+    END,       //!< The input was closed.
+  };
+
+  /// One key.
+  struct Key {
+    key_e type = key_e::END; //!< What the key is.
+    char32_t ch = 0;         //!< The character, if type is CHAR.
+  };
+
+  /// Longest line read_line() keeps; the rest of a longer line is dropped.
+  static constexpr size_t MAX_LINE = 256;
+  /// How long an escape waits for the rest of a sequence.
+  static constexpr int ESCAPE_TIMEOUT_MS = 50;
+
+private:
+  //=== Decoder tables
+  /// Byte classes.
+  enum class_e : uint8_t {
+    C_IGNORE, //!< Other control characters, including '\r'.
+    C_ENTER,  //!< '\n'.
+    C_BACK,   //!< Backspace and Delete.
+    C_ESC,    //!< Escape.
+    C_PARAM,  //!< 0x20-0x3F: printable, and CSI parameters.
+    C_FINAL,  //!< 0x40-0x7E but '[' and 'O': printable, and CSI final bytes.
+    C_CSI,    //!< '[': printable, or starts a CSI after an escape.
+    C_SS3,    //!< 'O': printable, or starts an SS3 after an escape.
+    C_CONT,   //!< UTF-8 continuation byte.
+    C_LEAD2,  //!< UTF-8 lead byte of a 2 byte sequence.
+    C_LEAD3,  //!< UTF-8 lead byte of a 3 byte sequence.
+    C_LEAD4,  //!< UTF-8 lead byte of a 4 byte sequence.
+    C_BAD,    //!< Never valid in UTF-8.
+    N_CLASSES
+  };
+
+  /// Decoder states.
+  enum state_e : uint8_t {
+    GROUND,   //!< Between keys.
+    ESCAPE,   //!< After an escape.
+    CSI,      //!< Inside "ESC [ ...".
+    SS3,      //!< After "ESC O".
+    NEED1,    //!< One UTF-8 continuation byte to go.
+    NEED2,    //!< Two to go.
+    NEED3,    //!< Three to go.
+    N_STATES
+  };
+
+  /// What a transition does.
+  enum action_e : uint8_t {
+    NONE,      //!< Nothing.
+    ASCII,     //!< Emit the byte as a character.
+    START2,    //!< Start a 2 byte character.
+    START3,    //!< Start a 3 byte character.
+    START4,    //!< Start a 4 byte character.
+    MORE,      //!< Add a continuation byte.
+    LAST,      //!< Add the final continuation byte, emit the character.
+    ENTER,     //!< Emit Enter.
+    BACK,      //!< Emit Backspace.
+    SEQUENCE,  //!< Emit a special key.
+    DROP,      //!< Discard a byte that cannot start a key.
+    RETRY,     //!< Give up on a cut short character; decode the byte again.
+  };
+
+  /// A transition.
+  struct Step {
+    state_e next;
+    action_e action;
+  };
+
+  static constexpr std::array<class_e, 256> make_classes() {
+    std::array<class_e, 256> classes{};
+    for (int b = 0; b < 256; ++b) {
+      class_e c = C_BAD;
+      if (b == '\n') { c = C_ENTER; }
+      else if (b == 0x08 || b == 0x7f) { c = C_BACK; }
+      else if (b == 0x1b) { c = C_ESC; }
+      else if (b < 0x20) { c = C_IGNORE; }
+      else if (b < 0x40) { c = C_PARAM; }
+      else if (b == '[') { c = C_CSI; }
+      else if (b == 'O') { c = C_SS3; }
+      else if (b < 0x7f) { c = C_FINAL; }
+      else if (b < 0xc0) { c = C_CONT; }
+      else if (b >= 0xc2 && b < 0xe0) { c = C_LEAD2; }
+      else if (b >= 0xe0 && b < 0xf0) { c = C_LEAD3; }
+      else if (b >= 0xf0 && b < 0xf5) { c = C_LEAD4; }
+      classes[b] = c;
+    }
+    return classes;
+  }
+
+  static constexpr std::array<std::array<Step, N_CLASSES>, N_STATES> make_steps() {
+    std::array<std::array<Step, N_CLASSES>, N_STATES> steps{};
+    // Between keys.
+    auto &ground = steps[GROUND];
+    ground = {{{GROUND, NONE}, {GROUND, ENTER}, {GROUND, BACK}, {ESCAPE, NONE}, {GROUND, ASCII},
+               {GROUND, ASCII}, {GROUND, ASCII}, {GROUND, ASCII}, {GROUND, DROP}, {NEED1, START2},
+               {NEED2, START3}, {NEED3, START4}, {GROUND, DROP}}};
+    // After an escape: a sequence, or Alt plus a key (reported as a sequence).
+    steps[ESCAPE] = ground;
+    steps[ESCAPE][C_CSI] = {CSI, NONE};
+    steps[ESCAPE][C_SS3] = {SS3, NONE};
+    steps[ESCAPE][C_PARAM] = steps[ESCAPE][C_FINAL] = {GROUND, SEQUENCE};
+    steps[ESCAPE][C_ESC] = {ESCAPE, NONE};
+    // "ESC [" parameters, up to a final byte.
+    steps[CSI] = steps[GROUND];
+    steps[CSI][C_PARAM] = {CSI, NONE};
+    for (auto c : {C_FINAL, C_CSI, C_SS3}) { steps[CSI][c] = {GROUND, SEQUENCE}; }
+    steps[CSI][C_ESC] = {ESCAPE, NONE};
+    // "ESC O" and one byte.
+    steps[SS3] = steps[GROUND];
+    for (auto c : {C_PARAM, C_FINAL, C_CSI, C_SS3}) { steps[SS3][c] = {GROUND, SEQUENCE}; }
+    steps[SS3][C_ESC] = {ESCAPE, NONE};
+    // Inside a UTF-8 character, anything but a continuation byte cuts it short.
+    for (state_e s : {NEED1, NEED2, NEED3}) {
+      for (auto &step : steps[s]) { step = {GROUND, RETRY}; }
+    }
+    steps[NEED1][C_CONT] = {GROUND, LAST};
+    steps[NEED2][C_CONT] = {NEED1, MORE};
+    steps[NEED3][C_CONT] = {NEED2, MORE};
+    return steps;
+  }
+
+  /// Class of each byte, and the transition for each state and class (built below).
+  static const std::array<class_e, 256> CLASSES;
+  static const std::array<std::array<Step, N_CLASSES>, N_STATES> STEPS;
+
+  //=== Data members
+  int m_in;                        //!< Where keys are read from.
+  int m_out;                       //!< Where read_line() echoes, in raw mode.
+  bool m_tty;                      //!< Whether m_in is a terminal.
+  bool m_raw = false;              //!< Whether raw mode is on.
+  bool m_closed = false;           //!< Whether m_in reached its end.
+  std::array<char, 256> m_buffer{}; //!< Bytes read and not decoded yet.
+  size_t m_begin = 0, m_end = 0;   //!< Undecoded bytes in m_buffer.
+  state_e m_state = GROUND;        //!< Decoder state.
+  char32_t m_partial = 0;          //!< UTF-8 character being decoded.
+
+  /// Terminal settings to restore; shared with the exit and signal handlers.
+  static inline termios s_saved{};
+  static inline int s_saved_fd = -1;
+
+public:
+  /// Read keys from `in`, echoing lines on `out`.
+  explicit Terminal(int in = STDIN_FILENO, int out = STDOUT_FILENO)
+      : m_in{in}, m_out{out}, m_tty{::isatty(in) == 1} {}
+  Terminal(const Terminal &) = delete;
+  Terminal &operator=(const Terminal &) = delete;
+  ~Terminal() { restore(); }
+
+  /// Return whether keys are read one by one, as they are pressed.
+  [[nodiscard]] bool raw() const { return m_tty; }
+
+  /**
+   * @brief Read the next key.
+   *
+   * @param timeout_ms Most time to wait, or -1 to wait for a key.
+   * @return The key; TIMEOUT if none came in time, END once the input is closed.
+   */
+  Key read_key(int timeout_ms = -1) {
+    if (m_tty) { return next(timeout_ms); }
+    // Line input: the first key of the line, the rest is skipped.
+    Key first = next(timeout_ms);
+    if (first.type == key_e::TIMEOUT || first.type == key_e::END || first.type == key_e::ENTER) {
+      return first;
+    }
+    for (Key key = first; key.type != key_e::ENTER && key.type != key_e::END;) { key = next(-1); }
+    return first;
+  }
+
+  /**
+   * @brief Read a line, echoing it and handling Backspace in raw mode.
+   *
+   * @param line Receives the line, without its end; at most MAX_LINE characters.
+   * @return false if the input was closed before a line was read.
+   */
+  bool read_line(std::wstring &line) {
+    line.clear();
+    line.reserve(MAX_LINE);
+    for (;;) {
+      Key key = next(-1);
+      switch (key.type) {
+      case key_e::END:
+        return !line.empty();
+      case key_e::ENTER:
+        echo("\r\n", 2);
+        return true;
+      case key_e::BACKSPACE:
+        if (!line.empty()) {
+          line.pop_back();
+          echo("\b \b", 3);
+        }
+        break;
+      case key_e::CHAR:
+        if (line.size() < MAX_LINE) {
+          line.push_back(static_cast<wchar_t>(key.ch));
+          char bytes[4];
+          echo(bytes, encode(key.ch, bytes));
+        }
+        break;
+      default:
+        break;
+      }
+    }
+  }
+
+  /// Leave raw mode, if it is on.
+  void restore() {
+    if (!m_raw) { return; }
+    ::tcsetattr(m_in, TCSAFLUSH, &s_saved);
+    s_saved_fd = -1;
+    m_raw = false;
+  }
+
+private:
+  /// Switch the terminal to raw mode, once.
+  void enter_raw() {
+    if (m_raw || !m_tty || ::tcgetattr(m_in, &s_saved) != 0) { return; }
+    termios raw = s_saved;
+    raw.c_lflag &= ~static_cast<tcflag_t>(ICANON | ECHO);
+    raw.c_cc[VMIN] = 1;
+    raw.c_cc[VTIME] = 0;
+    if (::tcsetattr(m_in, TCSAFLUSH, &raw) != 0) { return; }
+    m_raw = true;
+    s_saved_fd = m_in;
+    static bool handlers = false;
+    if (!handlers) {
+      handlers = true;
+      std::atexit([] {
+        if (s_saved_fd >= 0) { ::tcsetattr(s_saved_fd, TCSAFLUSH, &s_saved); }
+      });
+      for (int sig : {SIGINT, SIGTERM, SIGHUP, SIGQUIT}) { std::signal(sig, on_signal); }
+    }
+  }
+
+  /// Restore the terminal, then die of the signal as usual.
+  static void on_signal(int sig) {
+    if (s_saved_fd >= 0) { ::tcsetattr(s_saved_fd, TCSAFLUSH, &s_saved); }
+    std::signal(sig, SIG_DFL);
+    std::raise(sig);
+  }
+
+  /// Write bytes on the terminal, in raw mode.
+  void echo(const char *bytes, size_t n) {
+    if (!m_raw) { return; }
+    while (n > 0) {
+      ssize_t written = ::write(m_out, bytes, n);
+      if (written < 0 && errno == EINTR) { continue; }
+      if (written <= 0) { return; }
+      bytes += written;
+      n -= static_cast<size_t>(written);
+    }
+  }
+
+  /// Encode a character as UTF-8 into `out`, returning its size.
+  static size_t encode(char32_t c, char *out) {
+    if (c < 0x80) {
+      out[0] = static_cast<char>(c);
+      return 1;
+    }
+    if (c < 0x800) {
+      out[0] = static_cast<char>(0xc0 | (c >> 6));
+      out[1] = static_cast<char>(0x80 | (c & 0x3f));
+      return 2;
+    }
+    if (c < 0x10000) {
+      out[0] = static_cast<char>(0xe0 | (c >> 12));
+      out[1] = static_cast<char>(0x80 | ((c >> 6) & 0x3f));
+      out[2] = static_cast<char>(0x80 | (c & 0x3f));
+      return 3;
+    }
+    out[0] = static_cast<char>(0xf0 | (c >> 18));
+    out[1] = static_cast<char>(0x80 | ((c >> 12) & 0x3f));
+    out[2] = static_cast<char>(0x80 | ((c >> 6) & 0x3f));
+    out[3] = static_cast<char>(0x80 | (c & 0x3f));
+    return 4;
+  }
+
+  /**
+   * @brief Wait for input and read it into the buffer.
+   *
+   * @return 1 if bytes were read, 0 on timeout, -1 at the end of the input.
+   */
+  int fill(int timeout_ms) {
+    if (m_closed) { return -1; }
+    pollfd pfd{m_in, POLLIN, 0};
+    int ready;
+    do { ready = ::poll(&pfd, 1, timeout_ms); } while (ready < 0 && errno == EINTR);
+    if (ready == 0) { return 0; }
+    ssize_t n;
+    do { n = ::read(m_in, m_buffer.data(), m_buffer.size()); } while (n < 0 && errno == EINTR);
+    if (n <= 0) {
+      m_closed = true;
+      return -1;
+    }
+    m_begin = 0;
+    m_end = static_cast<size_t>(n);
+    return 1;
+  }
+
+  /// Decode the next key, reading more input as needed.
+  Key next(int timeout_ms) {
+    enter_raw();
+    for (;;) {
+      if (m_begin == m_end) {
+        // A lone escape is the Escape key once nothing follows it.
+        int wait = m_state == ESCAPE ? ESCAPE_TIMEOUT_MS : timeout_ms;
+        int filled = fill(wait);
+        if (filled <= 0 && m_state == ESCAPE) {
+          m_state = GROUND;
+          return {key_e::ESCAPE, 0};
+        }
+        if (filled == 0) { return {key_e::TIMEOUT, 0}; }
+        if (filled < 0) {
+          m_state = GROUND;
+          return {key_e::END, 0};
+        }
+      }
+      auto byte = static_cast<unsigned char>(m_buffer[m_begin++]);
+      Step step = STEPS[m_state][CLASSES[byte]];
+      m_state = step.next;
+      switch (step.action) {
+      case ASCII:
+        return {key_e::CHAR, byte};
+      case START2:
+        m_partial = byte & 0x1f;
+        break;
+      case START3:
+        m_partial = byte & 0x0f;
+        break;
+      case START4:
+        m_partial = byte & 0x07;
+        break;
+      case MORE:
+        m_partial = (m_partial << 6) | (byte & 0x3f);
+        break;
+      case LAST:
+        return {key_e::CHAR, (m_partial << 6) | (byte & 0x3f)};
+      case ENTER:
+        return {key_e::ENTER, 0};
+      case BACK:
+        return {key_e::BACKSPACE, 0};
+      case SEQUENCE:
+        return {key_e::SEQUENCE, 0};
+      case RETRY:
+        --m_begin;
+        break;
+      case NONE:
+      case DROP:
+        break;
+      }
+    }
+  }
+};
+
+inline constexpr std::array<Terminal::class_e, 256> Terminal::CLASSES = Terminal::make_classes();
+inline constexpr std::array<std::array<Terminal::Step, Terminal::N_CLASSES>, Terminal::N_STATES> Terminal::STEPS =
+    Terminal::make_steps();
+
+#endif
@@ -26,6 +26,13 @@
  *      return 0;
  *  }
  * ```
+ *
+ * Styled text can also be composed at compile time, into a constant
+ * that is written out as a plain run of characters:
+ * ```c++
+ *  constexpr auto title = Color::styled<Color::RED, Color::BOLD>(L"Hangman") + Color::text(L"\n");
+ *  frame << title.view();
+ * ```
  */
 #include <sstream>
 using std::ostringstream;
@@ -35,6 +42,8 @@ using std::string;
 using std::wstring;
 #include <array>
 using std::array;
+#include <cstddef>
+#include <string_view>
 
 namespace Color {
 // Alias
@@ -65,7 +74,7 @@ static constexpr short BLINK{5};
 static constexpr short REVERSE{7};
 
 /// List of colors. You may which to change color ordering.
-static constexpr array color_list{31, 32, 33, 34, 35, 36, 37,
+inline constexpr array color_list{31, 32, 33, 34, 35, 36, 37,
                                   91, 92, 93, 94, 95, 96, 97};
 
 /// Returns a string with a colored message.
@@ -89,5 +98,75 @@ inline wstring wtcolor(const wstring &msg, short color = Color::WHITE,
   oss << L"\33[" << modifier << L";" << color << L"m" << msg << L"\33[0m";
   return oss.str();
 }
+
+/// A string built at compile time.
+template <typename CharT, size_t N> struct Text {
+  CharT chars[N + 1]{}; //!< The characters, followed by a '\0'.
+
+  /// Return the number of characters.
+  [[nodiscard]] constexpr size_t size() const { return N; }
+  /// Return the characters.
+  [[nodiscard]] constexpr std::basic_string_view<CharT> view() const { return {chars, N}; }
+};
+
+/// Write a Text to a stream, as one run of characters.
+template <typename CharT, size_t N>
+std::basic_ostream<CharT> &operator<<(std::basic_ostream<CharT> &os, const Text<CharT, N> &t) {
+  return os << t.view();
+}
+
+/// Make a Text out of a string literal.
+template <typename CharT, size_t N> constexpr Text<CharT, N - 1> text(const CharT (&s)[N]) {
+  Text<CharT, N - 1> t;
+  for (size_t i = 0; i + 1 < N; ++i) { t.chars[i] = s[i]; }
+  return t;
+}
+
+/// Join two Texts.
+template <typename CharT, size_t A, size_t B>
+constexpr Text<CharT, A + B> operator+(const Text<CharT, A> &a, const Text<CharT, B> &b) {
+  Text<CharT, A + B> t;
+  for (size_t i = 0; i < A; ++i) { t.chars[i] = a.chars[i]; }
+  for (size_t i = 0; i < B; ++i) { t.chars[A + i] = b.chars[i]; }
+  return t;
+}
+
+namespace detail {
+/// Number of decimal digits of a color attribute.
+constexpr size_t digits(short value) { return value < 10 ? 1 : 1 + digits(value / 10); }
+
+/// Text of the escape sequence that sets `modifier` and `color`: "\33[1;31m".
+template <typename CharT, short color, short modifier>
+constexpr Text<CharT, 4 + digits(modifier) + digits(color)> sgr() {
+  Text<CharT, 4 + digits(modifier) + digits(color)> t;
+  size_t i = 0;
+  t.chars[i++] = CharT('\33');
+  t.chars[i++] = CharT('[');
+  for (size_t d = digits(modifier), v = modifier; d > 0; --d, v /= 10) { t.chars[i + d - 1] = CharT('0' + v % 10); }
+  i += digits(modifier);
+  t.chars[i++] = CharT(';');
+  for (size_t d = digits(color), v = color; d > 0; --d, v /= 10) { t.chars[i + d - 1] = CharT('0' + v % 10); }
+  i += digits(color);
+  t.chars[i] = CharT('m');
+  return t;
+}
+
+/// Text of the escape sequence that resets every attribute: "\33[0m".
+template <typename CharT> constexpr Text<CharT, 4> reset() {
+  return text<CharT>({CharT('\33'), CharT('['), CharT('0'), CharT('m'), CharT('\0')});
+}
+} // namespace detail
+
+/// Compile time tcolor(): `msg` between the escape codes of `color`/`modifier` and a reset.
+template <short color, short modifier = REGULAR, typename CharT, size_t N>
+constexpr auto styled(const Text<CharT, N> &msg) {
+  return detail::sgr<CharT, color, modifier>() + msg + detail::reset<CharT>();
+}
+
+/// Compile time tcolor() of a string literal.
+template <short color, short modifier = REGULAR, typename CharT, size_t N>
+constexpr auto styled(const CharT (&msg)[N]) {
+  return styled<color, modifier>(text(msg));
+}
 } // namespace Color
 #endif
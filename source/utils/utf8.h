@@ -0,0 +1,108 @@
+#ifndef UTF8_H
+#define UTF8_H
+
+/*!
+ * Minimal UTF-8 helpers.
+ *
+ * Decodes UTF-8 straight into code points, replacing the deprecated
+ * `std::wstring_convert` / `std::codecvt_utf8_utf16` pair. Malformed
+ * sequences decode as U+FFFD instead of throwing.
+ */
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace utf8 {
+/// Code point used for malformed input.
+static constexpr char32_t REPLACEMENT{0xFFFD};
+
+/// Decodes the code point starting at `it` and advances `it` past it.
+/*!
+ * @param it Current position; must be before `end`.
+ * @param end One past the last byte of the input.
+ * @return The decoded code point, or REPLACEMENT on malformed input.
+ */
+inline char32_t decode(const char *&it, const char *end) {
+  auto lead = static_cast<unsigned char>(*it++);
+  if (lead < 0x80) { return lead; }
+  size_t extra;
+  char32_t cp;
+  if ((lead & 0xE0) == 0xC0) { extra = 1; cp = lead & 0x1F; }
+  else if ((lead & 0xF0) == 0xE0) { extra = 2; cp = lead & 0x0F; }
+  else if ((lead & 0xF8) == 0xF0) { extra = 3; cp = lead & 0x07; }
+  else { return REPLACEMENT; }
+  for (size_t i = 0; i < extra; ++i) {
+    if (it == end || (static_cast<unsigned char>(*it) & 0xC0) != 0x80) {
+      return REPLACEMENT;
+    }
+    cp = (cp << 6) | (static_cast<unsigned char>(*it++) & 0x3F);
+  }
+  return cp;
+}
+
+/// Appends the UTF-8 encoding of `cp` to `out`.
+inline void encode(std::string &out, char32_t cp) {
+  if (cp < 0x80) {
+    out.push_back(static_cast<char>(cp));
+  } else if (cp < 0x800) {
+    out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+    out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+  } else if (cp < 0x10000) {
+    out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+    out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+    out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+  } else {
+    out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+    out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+    out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+    out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+  }
+}
+
+/// Appends the UTF-8 encoding of a wide string to `out`.
+inline void encode(std::string &out, std::wstring_view in) {
+  for (wchar_t c : in) { encode(out, static_cast<char32_t>(c)); }
+}
+
+/// Decodes a whole UTF-8 string, replacing the contents of `out`.
+inline void decode(std::wstring &out, std::string_view in) {
+  out.clear();
+  const char *it = in.data();
+  const char *end = it + in.size();
+  while (it != end) { out.push_back(static_cast<wchar_t>(decode(it, end))); }
+}
+
+/// Wrapper that writes UTF-8 text to a wide stream (see widen()).
+struct Wide {
+  std::string_view text; //!< The UTF-8 text.
+};
+
+/// Wraps UTF-8 text so that `wos << utf8::widen(s)` decodes it on the fly,
+/// without building a temporary wide string.
+inline Wide widen(std::string_view text) { return {text}; }
+
+inline std::wostream &operator<<(std::wostream &os, Wide w) {
+  const char *it = w.text.data();
+  const char *end = it + w.text.size();
+  while (it != end) { os.put(static_cast<wchar_t>(decode(it, end))); }
+  return os;
+}
+
+/// Upper-cases ASCII and Latin-1 letters (which covers Portuguese).
+inline constexpr char32_t to_upper(char32_t c) {
+  if (c >= U'a' && c <= U'z') { return c - 0x20; }
+  if (c >= 0xE0 && c <= 0xFE && c != 0xF7) { return c - 0x20; }
+  return c;
+}
+
+/// Decodes `in`, upper-cases it and appends it to `out`.
+inline void append_upper(std::wstring &out, std::string_view in) {
+  const char *it = in.data();
+  const char *end = it + in.size();
+  out.reserve(out.size() + in.size()); // Never fewer bytes than code points.
+  while (it != end) {
+    out.push_back(static_cast<wchar_t>(to_upper(decode(it, end))));
+  }
+}
+} // namespace utf8
+#endif